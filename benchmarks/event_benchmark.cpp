@@ -0,0 +1,163 @@
+#include "../src/event_manager/event_manager.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*
+* Emit throughput of the EventManager against the dispatch it replaced, kept here as
+* 'legacy': handler lists keyed by std::type_index, one virtual callback per listener.
+*/
+namespace legacy {
+
+	class IEventCallback {
+	public:
+		virtual ~IEventCallback() = default;
+
+		void execute(Event& e) { call(e); }
+
+	private:
+		virtual void call(Event& e) = 0;
+	};
+
+	template <typename TOwner, typename TEvent>
+	class EventCallback : public IEventCallback {
+		using CallbackFunction = void (TOwner::*)(TEvent&);
+
+	public:
+		EventCallback(TOwner* owner_instance, CallbackFunction callback_function) :
+			owner_instance{ owner_instance },
+			callback_function{ callback_function } {
+		}
+
+		~EventCallback() final override = default;
+
+		EventCallback(const EventCallback&) = delete;
+		EventCallback& operator=(const EventCallback&) = delete;
+
+	private:
+		TOwner* owner_instance{};
+		CallbackFunction callback_function{};
+
+		void call(Event& e) final override { std::invoke(callback_function, owner_instance, static_cast<TEvent&>(e)); }
+	};
+
+	using EventHandlerList = std::list<std::unique_ptr<IEventCallback>>;
+
+	class EventManager {
+	public:
+		template <typename TOwner, typename TEvent>
+		void listen(TOwner* owner_instance, void (TOwner::* callback_function)(TEvent&)) {
+			if (!listeners[typeid(TEvent)]) {
+				listeners[typeid(TEvent)] = std::make_unique<EventHandlerList>();
+			}
+
+			listeners[typeid(TEvent)]->push_back(std::make_unique<EventCallback<TOwner, TEvent>>(owner_instance, callback_function));
+		}
+
+		template<typename TEvent, typename ...Args>
+		void emit(Args&& ...args) {
+			EventHandlerList* handlers = listeners[typeid(TEvent)].get();
+
+			if (handlers) {
+				for (auto itr{ handlers->begin() }; itr != handlers->end(); ++itr) {
+					TEvent event{ std::forward<Args>(args)... };
+					(*itr)->execute(event);
+				}
+			}
+		}
+
+	private:
+		std::unordered_map<std::type_index, std::unique_ptr<EventHandlerList>> listeners{};
+	};
+}
+
+namespace {
+
+	using Clock = std::chrono::steady_clock;
+
+	constexpr int event_types{ 8 };
+	constexpr int listeners_per_type{ 4 };
+	constexpr int emits{ 2000000 };
+
+	template <int N>
+	class BenchEvent : public Event {
+	public:
+		int value{};
+
+		BenchEvent(int value) : value{ value } {}
+	};
+
+	struct Listener {
+		std::int64_t sum{};
+
+		template <int N>
+		void on_event(BenchEvent<N>& event) { sum += event.value; }
+	};
+
+	template <typename TManager, std::size_t ...N>
+	void emit_all(TManager& event_manager, std::index_sequence<N...>) {
+		for (int i{}; i < emits; i += event_types) {
+			(event_manager.template emit<BenchEvent<static_cast<int>(N)>>(i), ...);
+		}
+	}
+
+	template <typename TFunction>
+	double elapsed_ms(TFunction&& function) {
+		const Clock::time_point start{ Clock::now() };
+		function();
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	std::int64_t total(const std::vector<Listener>& listeners) {
+		std::int64_t sum{};
+		for (const Listener& listener : listeners) {
+			sum += listener.sum;
+		}
+		return sum;
+	}
+
+	template <std::size_t ...N>
+	bool emit_throughput(std::index_sequence<N...> types) {
+		std::vector<Listener> listeners(listeners_per_type);
+		std::vector<Listener> legacy_listeners(listeners_per_type);
+
+		EventManager event_manager{};
+		legacy::EventManager legacy_event_manager{};
+		std::vector<EventSubscription> subscriptions{};
+
+		for (std::size_t i{}; i < listeners_per_type; ++i) {
+			(subscriptions.push_back(event_manager.listen<&Listener::template on_event<static_cast<int>(N)>>(&listeners[i])), ...);
+			(legacy_event_manager.listen(&legacy_listeners[i], &Listener::template on_event<static_cast<int>(N)>), ...);
+		}
+
+		const double ms{ elapsed_ms([&] { emit_all(event_manager, types); }) };
+		const double legacy_ms{ elapsed_ms([&] { emit_all(legacy_event_manager, types); }) };
+
+		const double deliveries{ static_cast<double>(emits) * listeners_per_type };
+		std::cout << emits << " emits over " << event_types << " types, " << listeners_per_type << " listeners each\n"
+			<< "EventManager: " << ms << " ms, " << deliveries / ms / 1000.0 << " M deliveries/s\n"
+			<< "legacy: " << legacy_ms << " ms, " << deliveries / legacy_ms / 1000.0 << " M deliveries/s, x" << legacy_ms / ms << "\n";
+
+		if (total(listeners) != total(legacy_listeners)) {
+			std::cerr << "EventManager and legacy deliveries differ\n";
+			return false;
+		}
+		return true;
+	}
+}
+
+int main() {
+	bool passed{ emit_throughput(std::make_index_sequence<event_types>{}) };
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
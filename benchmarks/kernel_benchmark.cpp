@@ -0,0 +1,147 @@
+#include "../src/collision/aabb_kernel.hpp"
+#include "../src/particles/particle_kernel.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/*
+* Times the SIMD kernels compiled into this build (see ENGINE_SIMD) against their scalar
+* reference on the same data. The results of both paths are compared first.
+*/
+namespace {
+
+	using Clock = std::chrono::steady_clock;
+
+	constexpr int iterations{ 20 };
+
+	template <typename TFunction>
+	double average_ms(TFunction&& function) {
+		const Clock::time_point start{ Clock::now() };
+
+		for (int i{}; i < iterations; ++i) {
+			function();
+		}
+
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+	}
+
+	void report(const char* name, const char* kernel_name, double kernel_ms, double scalar_ms) {
+		std::cout << name << ": " << kernel_ms << " ms (" << kernel_name << "), "
+			<< scalar_ms << " ms (scalar), x" << scalar_ms / kernel_ms << "\n";
+	}
+
+	// Every box against the ones after it, as the collision broadphase does.
+	template <typename TOverlap>
+	std::size_t all_pairs(const ColliderBounds& bounds, std::vector<std::uint32_t>& hits, TOverlap overlap) {
+		std::size_t pairs{};
+
+		for (std::size_t i{}; i < bounds.size(); ++i) {
+			hits.clear();
+			overlap(bounds, i, i + 1, bounds.size(), hits);
+			pairs += hits.size();
+		}
+
+		return pairs;
+	}
+
+	bool aabb_overlap() {
+		constexpr std::size_t box_count{ 3000 };
+		constexpr float box_size{ 32.0f };
+
+		std::mt19937 random{ 26 };
+		std::uniform_real_distribution<float> position{ 0.0f, 2048.0f };
+
+		ColliderBounds bounds{};
+		for (std::size_t i{}; i < box_count; ++i) {
+			const float x{ static_cast<float>(static_cast<int>(position(random))) };
+			const float y{ static_cast<float>(static_cast<int>(position(random))) };
+			bounds.push_back(x, y, x + box_size, y + box_size);
+		}
+
+		std::vector<std::uint32_t> kernel_hits{};
+		std::vector<std::uint32_t> scalar_hits{};
+
+		for (std::size_t i{}; i < box_count; ++i) {
+			kernel_hits.clear();
+			scalar_hits.clear();
+			aabb_kernel::overlap(bounds, i, 0, box_count, kernel_hits);
+			aabb_kernel::overlap_scalar(bounds, i, 0, box_count, scalar_hits);
+
+			if (kernel_hits != scalar_hits) {
+				std::cerr << "aabb_kernel::overlap differs from the scalar path for box " << i << "\n";
+				return false;
+			}
+		}
+
+		auto kernel = [](const ColliderBounds& b, std::size_t i, std::size_t first, std::size_t last, std::vector<std::uint32_t>& hits) {
+			aabb_kernel::overlap(b, i, first, last, hits);
+		};
+		auto scalar = [](const ColliderBounds& b, std::size_t i, std::size_t first, std::size_t last, std::vector<std::uint32_t>& hits) {
+			aabb_kernel::overlap_scalar(b, i, first, last, hits);
+		};
+
+		std::size_t kernel_pairs{};
+		std::size_t scalar_pairs{};
+		const double kernel_ms{ average_ms([&] { kernel_pairs = all_pairs(bounds, kernel_hits, kernel); }) };
+		const double scalar_ms{ average_ms([&] { scalar_pairs = all_pairs(bounds, scalar_hits, scalar); }) };
+
+		std::cout << box_count << " boxes, " << kernel_pairs << " overlapping pairs\n";
+		report("aabb all-pairs pass", aabb_kernel::name(), kernel_ms, scalar_ms);
+		return kernel_pairs == scalar_pairs;
+	}
+
+	bool same_particles(const ParticleBuffer& a, const ParticleBuffer& b) {
+		return a.x == b.x && a.y == b.y && a.velocity_x == b.velocity_x && a.velocity_y == b.velocity_y &&
+			a.life == b.life && a.age == b.age && a.style == b.style;
+	}
+
+	bool particle_update() {
+		constexpr std::size_t particle_count{ 100000 };
+		constexpr float delta_time{ 1.0f / 30.0f };
+
+		std::mt19937 random{ 48 };
+		std::uniform_real_distribution<float> position{ 0.0f, 2048.0f };
+		std::uniform_real_distribution<float> velocity{ -100.0f, 100.0f };
+		std::uniform_real_distribution<float> lifetime{ 0.1f, 10.0f };
+
+		ParticleBuffer particles{};
+		particles.reserve(particle_count);
+		for (std::size_t i{}; i < particle_count; ++i) {
+			particles.push_back(position(random), position(random), velocity(random), velocity(random), lifetime(random), static_cast<std::uint16_t>(i % 4));
+		}
+
+		// Enough steps for some particles to expire and be compacted away
+		ParticleBuffer kernel_particles{ particles };
+		ParticleBuffer scalar_particles{ particles };
+		for (int step{}; step < 30; ++step) {
+			particle_kernel::update(kernel_particles, delta_time);
+			particle_kernel::update_scalar(scalar_particles, delta_time);
+
+			if (!same_particles(kernel_particles, scalar_particles)) {
+				std::cerr << "particle_kernel::update differs from the scalar path at step " << step << "\n";
+				return false;
+			}
+		}
+
+		kernel_particles = particles;
+		scalar_particles = particles;
+		const double kernel_ms{ average_ms([&] { particle_kernel::update(kernel_particles, delta_time); }) };
+		const double scalar_ms{ average_ms([&] { particle_kernel::update_scalar(scalar_particles, delta_time); }) };
+
+		std::cout << particle_count << " particles, " << kernel_particles.size() << " alive after " << iterations << " steps\n";
+		report("particle update step", particle_kernel::name(), kernel_ms, scalar_ms);
+		return same_particles(kernel_particles, scalar_particles);
+	}
+}
+
+int main() {
+	bool passed{ aabb_overlap() };
+	passed = particle_update() && passed;
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,80 @@
+#ifndef ANIMATION_CLIP_HPP
+#define ANIMATION_CLIP_HPP
+
+#include <SDL2/SDL_rect.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+* A sequence of sprite source rectangles (relative to the sprite texture) with their durations,
+* shared by every entity playing it. Entities only keep the clip and their time in it.
+* Events fire when the playback reaches their time (time 0 fires when a loop starts over).
+*/
+struct AnimationClip {
+	struct Event {
+		double time{};
+		std::string name{};
+	};
+
+	std::vector<SDL_Rect> frames{};
+	std::vector<double> frame_ends{}; // time at which every frame ends
+	std::vector<Event> events{};      // sorted by time
+	double duration{};
+	double frames_per_second{};       // > 0 when all the frames last the same
+	bool loop{ true };
+
+	void add_frame(const SDL_Rect& rect, double frame_duration) {
+		const bool is_uniform{ frames.empty() || (frames_per_second > 0.0 && frame_duration == frame_ends.front()) };
+
+		frames.push_back(rect);
+		duration += std::max(frame_duration, 0.0);
+		frame_ends.push_back(duration);
+
+		// Uniform clips find their frame with a multiply instead of a search
+		frames_per_second = is_uniform && frame_duration > 0.0 ? 1.0 / frame_duration : 0.0;
+	}
+
+	void add_event(double time, const std::string& name) {
+		auto it{ std::upper_bound(events.begin(), events.end(), time, [](double t, const Event& event) { return t < event.time; }) };
+		events.insert(it, { time, name });
+	}
+
+	// Index of the frame shown at 'time', in [0, duration].
+	// Accumulated step times land a rounding error short of frame boundaries, the tolerance absorbs it.
+	std::size_t frame_at(double time) const {
+		constexpr double tolerance{ 1e-9 };
+		time += tolerance;
+
+		std::size_t frame{};
+
+		if (frames_per_second > 0.0) {
+			frame = static_cast<std::size_t>(time * frames_per_second);
+		}
+		else {
+			frame = static_cast<std::size_t>(std::upper_bound(frame_ends.begin(), frame_ends.end(), time) - frame_ends.begin());
+		}
+
+		return std::min(frame, frames.size() - 1);
+	}
+
+	double frame_start(std::size_t frame) const {
+		return frame == 0 || frame_ends.empty() ? 0.0 : frame_ends[std::min(frame, frame_ends.size()) - 1];
+	}
+
+	// Frames laid out in a row starting at (x, y), 'frame_count' frames of 'frame_duration' seconds.
+	static AnimationClip strip(int x, int y, int width, int height, int frame_count, double frame_duration, bool loop = true) {
+		AnimationClip clip{};
+		clip.loop = loop;
+
+		for (int i{}; i < std::max(frame_count, 1); ++i) {
+			clip.add_frame({ x + i * width, y, width, height }, frame_duration);
+		}
+
+		return clip;
+	}
+};
+
+#endif //ANIMATION_CLIP_HPP
@@ -0,0 +1,26 @@
+#ifndef ASSET_HANDLE_HPP
+#define ASSET_HANDLE_HPP
+
+/*
+* Dense ids handed out by the AssetManager when an asset is loaded,
+* resolving one on the render path is an array index instead of a string hash.
+*/
+struct TextureHandle {
+	int index{ -1 };
+
+	bool is_valid() const { return index >= 0; }
+};
+
+struct FontHandle {
+	int index{ -1 };
+
+	bool is_valid() const { return index >= 0; }
+};
+
+struct AnimationClipHandle {
+	int index{ -1 };
+
+	bool is_valid() const { return index >= 0; }
+};
+
+#endif //ASSET_HANDLE_HPP
@@ -1,16 +1,42 @@
 #include "asset_manager.hpp"
 
-#include "../game/game.hpp"
 #include "../logger/logger.hpp"
-#include "../ecs/ecs.hpp"
-#include "../components/transform_component.hpp"
-#include "../components/sprite_component.hpp"
+#include "../tilemap/tilemap.hpp"
+
+#include "skyline_packer.hpp"
 
 #include <SDL2/SDL_image.h>
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <system_error>
+#include <utility>
+
+namespace {
+	constexpr const char* atlas_cache_header{ "atlas-cache 1" };
+
+	std::vector<std::string> split_tabs(const std::string& line) {
+		std::vector<std::string> fields{};
+		std::istringstream stream{ line };
+		std::string field{};
+		while (std::getline(stream, field, '\t')) {
+			fields.push_back(field);
+		}
+		return fields;
+	}
+
+	// The whole field as a number, false for anything else.
+	template <typename T>
+	bool parse_field(const std::string& field, T& value) {
+		const char* last{ field.data() + field.size() };
+		const std::from_chars_result result{ std::from_chars(field.data(), last, value) };
+		return !field.empty() && result.ec == std::errc{} && result.ptr == last;
+	}
+}
 
 AssetManager::AssetManager() {
 	Logger::log("Asset manager created!");
@@ -22,43 +48,333 @@ AssetManager::~AssetManager() {
 }
 
 void AssetManager::clear_assets() {
-	for (auto it{ textures.begin() }; it != textures.end();) {
-		SDL_DestroyTexture(it->second);
-		it->second = nullptr;
-		it = textures.erase(it);
+	for (SDL_Texture*& page : atlas_pages) {
+		SDL_DestroyTexture(page);
+		page = nullptr;
 	}
 
-	textures.clear();
+	atlas_pages.clear();
+	texture_regions.clear();
+	texture_handles.clear();
+	staged_textures.clear();
 
-	for (auto it{ fonts.begin() }; it != fonts.end();) {
-		TTF_CloseFont(it->second);
-		it->second = nullptr;
-		it = fonts.erase(it);
+	for (TTF_Font*& font : font_list) {
+		TTF_CloseFont(font);
+		font = nullptr;
 	}
 
-	fonts.clear();
+	font_list.clear();
+	glyph_atlases.clear();
+	font_handles.clear();
+
+	animation_clips.clear();
+	animation_clip_handles.clear();
 
 	maps.clear();
 }
 
-void AssetManager::add_texture(SDL_Renderer* renderer, const std::string& asset_id, const std::string& path) {
-	SDL_Texture* texture{ IMG_LoadTexture(renderer, path.c_str()) };
-	textures.insert(std::make_pair(asset_id, texture));
+TextureHandle AssetManager::add_texture(const std::string& asset_id, const std::string& path) {
+	auto iterator{ texture_handles.find(asset_id) };
+	if (iterator != texture_handles.end()) {
+		Logger::err("Texture id already in the asset store, keeping the first one. Id: " + asset_id);
+		return iterator->second;
+	}
+
+	TextureHandle handle{ static_cast<int>(texture_regions.size()) };
+	texture_regions.push_back({});
+	texture_handles.emplace(asset_id, handle);
+	staged_textures.push_back({ asset_id, path, handle });
 
-	Logger::log("New texture added to the asset store. Id: " + asset_id);
+	Logger::log("New texture staged in the asset store. Id: " + asset_id);
+	return handle;
 }
 
-SDL_Texture* AssetManager::get_texture(const std::string& asset_id) const {
-	auto iterator{ textures.find(asset_id) };
-	if (iterator == textures.end()) {
-		return nullptr;
+TextureHandle AssetManager::get_texture_handle(const std::string& asset_id) const {
+	auto iterator{ texture_handles.find(asset_id) };
+	if (iterator == texture_handles.end()) {
+		return {};
 	}
 	else {
 		return iterator->second;
 	}
 }
 
-void AssetManager::add_map(SDL_Renderer* renderer, const std::string asset_id, const std::string& map_path, const std::string& sheet_path) {
+SDL_Texture* AssetManager::get_texture(const std::string& asset_id) const {
+	return get_region(get_texture_handle(asset_id)).texture;
+}
+
+void AssetManager::build_atlases(SDL_Renderer* renderer, const std::string& cache_path) {
+	if (staged_textures.empty()) {
+		return;
+	}
+
+	const std::vector<std::string> key{ atlas_cache_key() };
+
+	if (!cache_path.empty() && load_atlas_cache(renderer, cache_path, key)) {
+		staged_textures.clear();
+		return;
+	}
+
+	std::vector<SDL_Surface*> images(staged_textures.size(), nullptr);
+	std::vector<std::size_t> order{};
+
+	for (std::size_t i{}; i < staged_textures.size(); ++i) {
+		images[i] = IMG_Load(staged_textures[i].path.c_str());
+
+		if (images[i] == nullptr) {
+			std::string err(SDL_GetError());
+			Logger::err("Failed to load texture '" + staged_textures[i].asset_id + "' at path '" + staged_textures[i].path + "': " + err);
+			continue;
+		}
+		order.push_back(i);
+	}
+
+	// Tallest first packs tighter, the stable sort keeps the result reproducible
+	std::stable_sort(order.begin(), order.end(), [&images](std::size_t a, std::size_t b) {
+		return images[a]->h != images[b]->h ? images[a]->h > images[b]->h : images[a]->w > images[b]->w;
+	});
+
+	std::vector<SkylinePacker> packers{};
+	std::vector<std::size_t> image_pages(images.size());
+	std::vector<SDL_Point> positions(images.size());
+
+	for (std::size_t i : order) {
+		const int w{ images[i]->w + atlas_padding };
+		const int h{ images[i]->h + atlas_padding };
+
+		std::size_t page{};
+		while (page < packers.size() && !packers[page].insert(w, h, positions[i])) {
+			++page;
+		}
+
+		if (page == packers.size()) {
+			// Images bigger than an atlas get a page of their own
+			packers.emplace_back(std::max(atlas_size, w), std::max(atlas_size, h));
+			packers.back().insert(w, h, positions[i]);
+		}
+
+		image_pages[i] = page;
+	}
+
+	std::vector<SDL_Surface*> pages{};
+	for (const SkylinePacker& packer : packers) {
+		pages.push_back(SDL_CreateRGBSurfaceWithFormat(0, packer.get_used_width(), packer.get_used_height(), 32, SDL_PIXELFORMAT_RGBA32));
+	}
+
+	for (std::size_t i : order) {
+		SDL_Surface* page{ pages[image_pages[i]] };
+		if (page == nullptr) {
+			continue;
+		}
+
+		// Copy the pixels as they are, alpha included
+		SDL_Rect dest_rect{ positions[i].x, positions[i].y, images[i]->w, images[i]->h };
+		SDL_SetSurfaceBlendMode(images[i], SDL_BLENDMODE_NONE);
+		SDL_BlitSurface(images[i], nullptr, page, &dest_rect);
+	}
+
+	const std::size_t first_page{ atlas_pages.size() };
+	for (SDL_Surface* page : pages) {
+		atlas_pages.push_back(page ? SDL_CreateTextureFromSurface(renderer, page) : nullptr);
+	}
+
+	for (std::size_t i : order) {
+		texture_regions[static_cast<std::size_t>(staged_textures[i].handle.index)] = {
+			atlas_pages[first_page + image_pages[i]],
+			{ positions[i].x, positions[i].y, images[i]->w, images[i]->h }
+		};
+	}
+
+	Logger::log("Packed " + std::to_string(order.size()) + " textures into " + std::to_string(pages.size()) + " atlas page(s)");
+
+	if (!cache_path.empty()) {
+		save_atlas_cache(cache_path, key, pages, first_page);
+	}
+
+	for (SDL_Surface* image : images) {
+		SDL_FreeSurface(image);
+	}
+	for (SDL_Surface* page : pages) {
+		SDL_FreeSurface(page);
+	}
+
+	staged_textures.clear();
+}
+
+// One line per staged texture, the cache is only valid for the exact same files.
+std::vector<std::string> AssetManager::atlas_cache_key() const {
+	std::vector<std::string> key{};
+
+	for (const StagedTexture& staged : staged_textures) {
+		std::error_code error{};
+		const auto size{ std::filesystem::file_size(staged.path, error) };
+		const auto modified{ std::filesystem::last_write_time(staged.path, error) };
+
+		std::string line{ staged.asset_id + '\t' + staged.path + '\t' };
+		if (error) {
+			line += "missing";
+		}
+		else {
+			line += std::to_string(size) + '\t' + std::to_string(modified.time_since_epoch().count());
+		}
+		key.push_back(line);
+	}
+
+	return key;
+}
+
+bool AssetManager::load_atlas_cache(SDL_Renderer* renderer, const std::string& cache_path, const std::vector<std::string>& key) {
+	std::ifstream file{ cache_path + ".index" };
+	if (!file) {
+		return false;
+	}
+
+	std::string line{};
+	std::size_t key_size{};
+	std::size_t page_count{};
+	std::size_t region_count{};
+
+	if (!std::getline(file, line) || line != atlas_cache_header || !(file >> key_size) || key_size != key.size()) {
+		return false;
+	}
+	file.ignore();
+
+	for (const std::string& key_line : key) {
+		if (!std::getline(file, line) || line != key_line) {
+			Logger::log("Atlas cache is out of date: " + cache_path);
+			return false;
+		}
+	}
+
+	// Every staged texture takes at most one region and one page, bigger counts mean a corrupt index
+	if (!(file >> page_count >> region_count) || page_count > key.size() || region_count > key.size()) {
+		Logger::err("Atlas cache index is corrupt, repacking: " + cache_path);
+		return false;
+	}
+	file.ignore();
+
+	std::vector<SDL_Texture*> pages{};
+	std::vector<SDL_Point> page_sizes{};
+	for (std::size_t i{}; i < page_count; ++i) {
+		const std::string page_path{ cache_path + "_" + std::to_string(i) + ".png" };
+		SDL_Texture* page{ IMG_LoadTexture(renderer, page_path.c_str()) };
+
+		if (page == nullptr) {
+			for (SDL_Texture* loaded : pages) {
+				SDL_DestroyTexture(loaded);
+			}
+			return false;
+		}
+
+		SDL_Point size{};
+		SDL_QueryTexture(page, nullptr, nullptr, &size.x, &size.y);
+		pages.push_back(page);
+		page_sizes.push_back(size);
+	}
+
+	// asset id, page, x, y, w, h; the rectangle has to lie inside its page
+	std::unordered_map<std::string, TextureRegion> cached_regions{};
+	bool is_valid{ true };
+
+	for (std::size_t i{}; i < region_count && is_valid; ++i) {
+		std::vector<std::string> fields{};
+		if (std::getline(file, line)) {
+			fields = split_tabs(line);
+		}
+
+		std::size_t page{};
+		SDL_Rect rect{};
+
+		is_valid = fields.size() == 6 &&
+			parse_field(fields[1], page) && page < page_count &&
+			parse_field(fields[2], rect.x) && parse_field(fields[3], rect.y) &&
+			parse_field(fields[4], rect.w) && parse_field(fields[5], rect.h) &&
+			rect.x >= 0 && rect.y >= 0 && rect.w > 0 && rect.h > 0 &&
+			rect.w <= page_sizes[page].x - rect.x && rect.h <= page_sizes[page].y - rect.y;
+
+		if (is_valid) {
+			cached_regions[fields[0]] = { pages[page], rect };
+		}
+	}
+
+	if (!is_valid || cached_regions.size() != region_count) {
+		Logger::err("Atlas cache index is corrupt, repacking: " + cache_path);
+		for (SDL_Texture* loaded : pages) {
+			SDL_DestroyTexture(loaded);
+		}
+		return false;
+	}
+
+	atlas_pages.insert(atlas_pages.end(), pages.begin(), pages.end());
+	for (const StagedTexture& staged : staged_textures) {
+		auto cached{ cached_regions.find(staged.asset_id) };
+		if (cached != cached_regions.end()) {
+			texture_regions[static_cast<std::size_t>(staged.handle.index)] = cached->second;
+		}
+	}
+
+	Logger::log("Texture atlases loaded from cache: " + cache_path);
+	return true;
+}
+
+void AssetManager::save_atlas_cache(
+	const std::string& cache_path,
+	const std::vector<std::string>& key,
+	const std::vector<SDL_Surface*>& pages,
+	std::size_t first_page
+) const {
+	std::error_code error{};
+	std::filesystem::create_directories(std::filesystem::path{ cache_path }.parent_path(), error);
+
+	for (std::size_t i{}; i < pages.size(); ++i) {
+		const std::string page_path{ cache_path + "_" + std::to_string(i) + ".png" };
+
+		if (pages[i] == nullptr || IMG_SavePNG(pages[i], page_path.c_str()) != 0) {
+			Logger::err("Failed to write atlas cache page: " + page_path);
+			return;
+		}
+	}
+
+	std::ofstream file{ cache_path + ".index", std::ios::trunc };
+	if (!file) {
+		Logger::err("Failed to write atlas cache index: " + cache_path + ".index");
+		return;
+	}
+
+	file << atlas_cache_header << '\n' << key.size() << '\n';
+	for (const std::string& key_line : key) {
+		file << key_line << '\n';
+	}
+
+	std::vector<std::string> lines{};
+	for (const StagedTexture& staged : staged_textures) {
+		const TextureRegion& region{ get_region(staged.handle) };
+		if (region.texture == nullptr) {
+			continue;
+		}
+
+		auto page{ std::find(atlas_pages.begin() + static_cast<std::ptrdiff_t>(first_page), atlas_pages.end(), region.texture) };
+		if (page == atlas_pages.end()) {
+			continue;
+		}
+
+		lines.push_back(
+			staged.asset_id + '\t' +
+			std::to_string(page - atlas_pages.begin() - static_cast<std::ptrdiff_t>(first_page)) + '\t' +
+			std::to_string(region.rect.x) + '\t' + std::to_string(region.rect.y) + '\t' +
+			std::to_string(region.rect.w) + '\t' + std::to_string(region.rect.h)
+		);
+	}
+
+	file << pages.size() << ' ' << lines.size() << '\n';
+	for (const std::string& line : lines) {
+		file << line << '\n';
+	}
+
+	Logger::log("Texture atlases cached to: " + cache_path);
+}
+
+void AssetManager::add_map(const std::string asset_id, const std::string& map_path) {
 
 	std::ifstream file{ map_path };
 
@@ -85,10 +401,9 @@ void AssetManager::add_map(SDL_Renderer* renderer, const std::string asset_id, c
 	}
 
 	maps.insert(std::make_pair(asset_id, map));
-	add_texture(renderer, asset_id, sheet_path);
 }
 
-void AssetManager::load_map(Registry* registry, const std::string& asset_id) {
+void AssetManager::load_map(Tilemap& tilemap, const std::string& asset_id, TextureHandle texture) const {
 
 	auto it{ maps.find(asset_id) };
 	if (it == maps.end()) {
@@ -96,64 +411,104 @@ void AssetManager::load_map(Registry* registry, const std::string& asset_id) {
 		return;
 	}
 
-	std::vector<std::vector<glm::ivec2>>& map{ it->second };
+	const std::vector<std::vector<glm::ivec2>>& map{ it->second };
 
-	constexpr double tile_scale{ 1.0 };
+	tilemap.set_texture(texture);
 
 	for (std::size_t row{}; row < map.size(); ++row) {
 		for (std::size_t col{}; col < map[row].size(); ++col) {
-
 			glm::ivec2 pos{ map[row][col] };
 
-			Entity tile{ registry->create_entity() };
-			tile.add_group("tiles");
-
-			tile.add_component<TransformComponent>(
-				glm::dvec2(
-					static_cast<double>(col) * sprite_config::width * tile_scale,
-					static_cast<double>(row) * sprite_config::height * tile_scale
-				),
-				glm::dvec2(tile_scale, tile_scale),
-				0.0
-			);
-
-			tile.add_component<SpriteComponent>(
-				asset_id,
-				0,
-				false,
-				sprite_config::width,
-				sprite_config::height,
-				sprite_config::width * pos.x,
-				sprite_config::height * pos.y
+			tilemap.set_tile(
+				static_cast<int>(col),
+				static_cast<int>(row),
+				{ static_cast<std::int16_t>(pos.x), static_cast<std::int16_t>(pos.y) }
 			);
 		}
 	}
-
-	Game::map_width = static_cast<int>(map.back().size()) * static_cast<int>(tile_scale) * sprite_config::height;
-	Game::map_height = static_cast<int>(map.size()) * static_cast<int>(tile_scale) * sprite_config::width;
 }
 
-void AssetManager::add_font(const std::string& asset_id, const std::string& path, int font_size) {
+FontHandle AssetManager::add_font(const std::string& asset_id, const std::string& path, int font_size) {
+
+	auto itr{ font_handles.find(asset_id) };
+	if (itr != font_handles.end()) {
+		return itr->second;
+	}
 
 	TTF_Font* font{ TTF_OpenFont(path.c_str(), font_size) };
 
 	if (font == nullptr) {
 		Logger::err("Failed to load font '" + asset_id + "' at path '" + path + "': " + TTF_GetError());
 		exit(EXIT_FAILURE);
-		return;
+		return {};
 	}
 
-	fonts.try_emplace(asset_id, font);
+	FontHandle handle{ static_cast<int>(font_list.size()) };
+	font_list.push_back(font);
+	glyph_atlases.emplace_back();
+	font_handles.emplace(asset_id, handle);
+
+	return handle;
 }
 
-TTF_Font* AssetManager::get_font(const std::string& asset_id) {
-	auto itr{ fonts.find(asset_id) };
-	auto end{ fonts.end() };
-	TTF_Font* font{ nullptr };
+FontHandle AssetManager::get_font_handle(const std::string& asset_id) const {
+	auto itr{ font_handles.find(asset_id) };
+	auto end{ font_handles.end() };
+	FontHandle handle{};
 
 	if (itr != end) {
-		font = itr->second;
+		handle = itr->second;
+	}
+
+	return handle;
+}
+
+TTF_Font* AssetManager::get_font(const std::string& asset_id) const {
+	return get_font(get_font_handle(asset_id));
+}
+
+void AssetManager::build_glyph_atlases(SDL_Renderer* renderer) {
+	for (std::size_t i{}; i < font_list.size(); ++i) {
+		if (glyph_atlases[i].is_valid()) {
+			continue;
+		}
+
+		if (!glyph_atlases[i].build(renderer, font_list[i])) {
+			Logger::err("Failed to build the glyph atlas of font " + std::to_string(i));
+		}
+	}
+}
+
+AnimationClipHandle AssetManager::add_animation_clip(const std::string& asset_id, AnimationClip clip) {
+	auto iterator{ animation_clip_handles.find(asset_id) };
+	if (iterator != animation_clip_handles.end()) {
+		return iterator->second;
+	}
+
+	if (clip.frames.empty()) {
+		Logger::err("Animation clip without frames, ignoring it. Id: " + asset_id);
+		return {};
 	}
 
-	return font;
+	// Playback would never leave the last frame
+	if (clip.frames.size() > 1 && clip.duration <= 0.0) {
+		Logger::err("Animation clip with several frames but no duration, ignoring it. Id: " + asset_id);
+		return {};
+	}
+
+	AnimationClipHandle handle{ static_cast<int>(animation_clips.size()) };
+	animation_clips.push_back(std::move(clip));
+	animation_clip_handles.emplace(asset_id, handle);
+
+	return handle;
+}
+
+AnimationClipHandle AssetManager::get_animation_clip_handle(const std::string& asset_id) const {
+	auto iterator{ animation_clip_handles.find(asset_id) };
+	if (iterator == animation_clip_handles.end()) {
+		return {};
+	}
+	else {
+		return iterator->second;
+	}
 }
@@ -1,7 +1,12 @@
 #ifndef ASSET_MANAGER_HPP
 #define ASSET_MANAGER_HPP
 
+#include "animation_clip.hpp"
+#include "asset_handle.hpp"
+#include "../renderer/glyph_atlas.hpp"
+
 #include <glm/glm.hpp>
+#include <SDL2/SDL_rect.h>
 #include <SDL2/SDL_ttf.h>
 
 #include <unordered_map>
@@ -10,8 +15,18 @@
 
 struct SDL_Texture;
 struct SDL_Renderer;
+struct SDL_Surface;
+
+class Tilemap;
 
-class Registry;
+/*
+* Where a texture asset lives: an atlas page and its rectangle inside it.
+* Source rectangles relative to the original image are offset by rect.x/rect.y.
+*/
+struct TextureRegion {
+	SDL_Texture* texture{ nullptr };
+	SDL_Rect rect{};
+};
 
 class AssetManager {
 public:
@@ -21,26 +36,96 @@ public:
 	void clear_assets();
 
 	//Textures
-	void add_texture(SDL_Renderer* renderer, const std::string& asset_id, const std::string& path);
+	// Textures are only staged here, build_atlases packs them into atlas pages.
+	// The handle is valid right away, its region once the atlases are built.
+	TextureHandle add_texture(const std::string& asset_id, const std::string& path);
+	TextureHandle get_texture_handle(const std::string& asset_id) const;
 	SDL_Texture* get_texture(const std::string& asset_id) const;
 
+	// Invalid handles resolve to an empty region (null texture).
+	const TextureRegion& get_region(TextureHandle handle) const {
+		return handle.is_valid() ? texture_regions[static_cast<std::size_t>(handle.index)] : empty_region;
+	}
+
+	// Packs the staged textures, reusing the pages cached at 'cache_path' (if any)
+	// when the staged files haven't changed since they were written.
+	void build_atlases(SDL_Renderer* renderer, const std::string& cache_path = "");
+
 	//Maps
-	void add_map(SDL_Renderer* renderer, const std::string asset_id, const std::string& map_path, const std::string& sheet_path);
-	void load_map(Registry* registry, const std::string& asset_id);
+	void add_map(const std::string asset_id, const std::string& map_path);
+	// Fills the tiles of an already sized tilemap, drawn from the given tile sheet.
+	void load_map(Tilemap& tilemap, const std::string& asset_id, TextureHandle texture) const;
 
 	//Fonts
-	void add_font(const std::string& asset_id, const std::string& path, int font_size);
-	TTF_Font* get_font(const std::string& asset_id);
+	FontHandle add_font(const std::string& asset_id, const std::string& path, int font_size);
+	FontHandle get_font_handle(const std::string& asset_id) const;
+	TTF_Font* get_font(const std::string& asset_id) const;
+
+	TTF_Font* get_font(FontHandle handle) const {
+		return handle.is_valid() ? font_list[static_cast<std::size_t>(handle.index)] : nullptr;
+	}
+
+	// Rasterizes the glyphs of the fonts added since the last call.
+	void build_glyph_atlases(SDL_Renderer* renderer);
+
+	// Null for invalid handles or fonts whose atlas isn't built.
+	const GlyphAtlas* get_glyph_atlas(FontHandle handle) const {
+		if (!handle.is_valid()) {
+			return nullptr;
+		}
+		const GlyphAtlas& atlas{ glyph_atlases[static_cast<std::size_t>(handle.index)] };
+		return atlas.is_valid() ? &atlas : nullptr;
+	}
+
+	//Animations
+	// Adding an id that already exists keeps the first clip, so entities sharing settings share the clip.
+	AnimationClipHandle add_animation_clip(const std::string& asset_id, AnimationClip clip);
+	AnimationClipHandle get_animation_clip_handle(const std::string& asset_id) const;
+
+	const AnimationClip& get_animation_clip(AnimationClipHandle handle) const {
+		return animation_clips[static_cast<std::size_t>(handle.index)];
+	}
+
+	std::size_t get_animation_clip_count() const { return animation_clips.size(); }
 
 private:
 	//Textures
-	std::unordered_map<std::string, SDL_Texture*> textures{};
+	static constexpr int atlas_size{ 2048 };
+	static constexpr int atlas_padding{ 1 };
+
+	struct StagedTexture {
+		std::string asset_id{};
+		std::string path{};
+		TextureHandle handle{};
+	};
+
+	static constexpr TextureRegion empty_region{};
+
+	std::vector<StagedTexture> staged_textures{};
+	std::vector<SDL_Texture*> atlas_pages{};
+	std::vector<TextureRegion> texture_regions{};
+	std::unordered_map<std::string, TextureHandle> texture_handles{};
+
+	std::vector<std::string> atlas_cache_key() const;
+	bool load_atlas_cache(SDL_Renderer* renderer, const std::string& cache_path, const std::vector<std::string>& key);
+	void save_atlas_cache(
+		const std::string& cache_path,
+		const std::vector<std::string>& key,
+		const std::vector<SDL_Surface*>& pages,
+		std::size_t first_page
+	) const;
 
 	//Maps
 	std::unordered_map<std::string, std::vector<std::vector<glm::ivec2>>> maps{};
 
 	//Fonts
-	std::unordered_map<std::string, TTF_Font*> fonts{};
+	std::vector<TTF_Font*> font_list{};
+	std::vector<GlyphAtlas> glyph_atlases{};
+	std::unordered_map<std::string, FontHandle> font_handles{};
+
+	//Animations
+	std::vector<AnimationClip> animation_clips{};
+	std::unordered_map<std::string, AnimationClipHandle> animation_clip_handles{};
 };
 
 #endif //ASSET_MANAGER_HPP
@@ -0,0 +1,122 @@
+#ifndef SKYLINE_PACKER_HPP
+#define SKYLINE_PACKER_HPP
+
+#include <SDL2/SDL_rect.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/*
+* Bottom-left skyline rectangle packer: the top edge of the packed area is kept as a list
+* of horizontal segments and every rectangle goes where its top ends up the lowest.
+*/
+class SkylinePacker {
+public:
+	SkylinePacker(int width, int height) : width{ width }, height{ height }, skyline{ { 0, 0, width } } {}
+
+	// Returns false if the rectangle doesn't fit anymore.
+	bool insert(int w, int h, SDL_Point& position) {
+		std::size_t best_index{ skyline.size() };
+		int best_top{ height + 1 };
+		int best_width{ width + 1 };
+		int best_y{};
+
+		for (std::size_t i{}; i < skyline.size(); ++i) {
+			int y{ fit(i, w, h) };
+			if (y < 0) {
+				continue;
+			}
+
+			if (y + h < best_top || (y + h == best_top && skyline[i].width < best_width)) {
+				best_index = i;
+				best_top = y + h;
+				best_width = skyline[i].width;
+				best_y = y;
+			}
+		}
+
+		if (best_index == skyline.size()) {
+			return false;
+		}
+
+		position = { skyline[best_index].x, best_y };
+		add_segment(best_index, { position.x, best_y + h, w });
+
+		used_width = std::max(used_width, position.x + w);
+		used_height = std::max(used_height, best_y + h);
+		return true;
+	}
+
+	int get_used_width() const { return used_width; }
+	int get_used_height() const { return used_height; }
+
+private:
+	struct Segment {
+		int x{};
+		int y{};
+		int width{};
+	};
+
+	int width{};
+	int height{};
+	int used_width{};
+	int used_height{};
+	std::vector<Segment> skyline{};
+
+	// Lowest y a w*h rectangle can take with its left edge on segment 'index', -1 if none.
+	int fit(std::size_t index, int w, int h) const {
+		if (skyline[index].x + w > width) {
+			return -1;
+		}
+
+		int y{ skyline[index].y };
+		int remaining{ w };
+
+		for (std::size_t i{ index }; remaining > 0 && i < skyline.size(); ++i) {
+			y = std::max(y, skyline[i].y);
+			if (y + h > height) {
+				return -1;
+			}
+			remaining -= skyline[i].width;
+		}
+
+		return y;
+	}
+
+	void add_segment(std::size_t index, Segment segment) {
+		skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(index), segment);
+
+		// Trim the segments now covered by the new one
+		for (std::size_t i{ index + 1 }; i < skyline.size();) {
+			const Segment& previous{ skyline[i - 1] };
+			Segment& current{ skyline[i] };
+
+			int overlap{ previous.x + previous.width - current.x };
+			if (overlap <= 0) {
+				break;
+			}
+
+			current.x += overlap;
+			current.width -= overlap;
+
+			if (current.width > 0) {
+				break;
+			}
+			skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+		}
+
+		// Merge neighbours at the same height
+		for (std::size_t i{}; i + 1 < skyline.size();) {
+			if (skyline[i].y == skyline[i + 1].y) {
+				skyline[i].width += skyline[i + 1].width;
+				skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+			}
+			else {
+				++i;
+			}
+		}
+	}
+};
+
+#endif //SKYLINE_PACKER_HPP
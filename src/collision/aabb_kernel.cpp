@@ -0,0 +1,157 @@
+#include "aabb_kernel.hpp"
+
+#if !defined(ENGINE_SIMD_SCALAR) && defined(__AVX2__)
+#define AABB_KERNEL_AVX2
+#include <immintrin.h>
+#elif !defined(ENGINE_SIMD_SCALAR) && defined(__SSE2__)
+#define AABB_KERNEL_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(AABB_KERNEL_AVX2) || defined(AABB_KERNEL_SSE2)
+namespace {
+
+	// Appends the index of every set bit of 'mask', offset by 'base'.
+	inline void push_mask(unsigned mask, std::size_t base, std::vector<std::uint32_t>& hits) {
+		while (mask != 0) {
+			unsigned bit{ static_cast<unsigned>(__builtin_ctz(mask)) };
+			hits.push_back(static_cast<std::uint32_t>(base + bit));
+			mask &= mask - 1;
+		}
+	}
+}
+#endif
+
+const char* aabb_kernel::name() {
+#if defined(AABB_KERNEL_AVX2)
+	return "avx2";
+#elif defined(AABB_KERNEL_SSE2)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+void aabb_kernel::overlap_scalar(
+	const ColliderBounds& bounds,
+	float x1,
+	float y1,
+	float x2,
+	float y2,
+	std::size_t first,
+	std::size_t last,
+	std::vector<std::uint32_t>& hits
+) {
+	const float a_x1{ x1 };
+	const float a_y1{ y1 };
+	const float a_x2{ x2 };
+	const float a_y2{ y2 };
+
+	for (std::size_t j{ first }; j < last; ++j) {
+		bool x_collision{ a_x1 < bounds.max_x[j] && a_x2 > bounds.min_x[j] };
+		bool y_collision{ a_y1 < bounds.max_y[j] && a_y2 > bounds.min_y[j] };
+
+		if (x_collision && y_collision) {
+			hits.push_back(static_cast<std::uint32_t>(j));
+		}
+	}
+}
+
+#if defined(AABB_KERNEL_AVX2)
+
+void aabb_kernel::overlap(
+	const ColliderBounds& bounds,
+	float x1,
+	float y1,
+	float x2,
+	float y2,
+	std::size_t first,
+	std::size_t last,
+	std::vector<std::uint32_t>& hits
+) {
+	const __m256 a_x1{ _mm256_set1_ps(x1) };
+	const __m256 a_y1{ _mm256_set1_ps(y1) };
+	const __m256 a_x2{ _mm256_set1_ps(x2) };
+	const __m256 a_y2{ _mm256_set1_ps(y2) };
+
+	auto test8 = [&](std::size_t j) -> unsigned {
+		__m256 x{ _mm256_and_ps(
+			_mm256_cmp_ps(a_x1, _mm256_loadu_ps(&bounds.max_x[j]), _CMP_LT_OQ),
+			_mm256_cmp_ps(a_x2, _mm256_loadu_ps(&bounds.min_x[j]), _CMP_GT_OQ)
+		) };
+		__m256 y{ _mm256_and_ps(
+			_mm256_cmp_ps(a_y1, _mm256_loadu_ps(&bounds.max_y[j]), _CMP_LT_OQ),
+			_mm256_cmp_ps(a_y2, _mm256_loadu_ps(&bounds.min_y[j]), _CMP_GT_OQ)
+		) };
+		return static_cast<unsigned>(_mm256_movemask_ps(_mm256_and_ps(x, y)));
+	};
+
+	std::size_t j{ first };
+	for (; j + 16 <= last; j += 16) {
+		unsigned mask{ test8(j) | (test8(j + 8) << 8) };
+		push_mask(mask, j, hits);
+	}
+	for (; j + 8 <= last; j += 8) {
+		push_mask(test8(j), j, hits);
+	}
+
+	overlap_scalar(bounds, x1, y1, x2, y2, j, last, hits);
+}
+
+#elif defined(AABB_KERNEL_SSE2)
+
+void aabb_kernel::overlap(
+	const ColliderBounds& bounds,
+	float x1,
+	float y1,
+	float x2,
+	float y2,
+	std::size_t first,
+	std::size_t last,
+	std::vector<std::uint32_t>& hits
+) {
+	const __m128 a_x1{ _mm_set1_ps(x1) };
+	const __m128 a_y1{ _mm_set1_ps(y1) };
+	const __m128 a_x2{ _mm_set1_ps(x2) };
+	const __m128 a_y2{ _mm_set1_ps(y2) };
+
+	auto test4 = [&](std::size_t j) -> unsigned {
+		__m128 x{ _mm_and_ps(
+			_mm_cmplt_ps(a_x1, _mm_loadu_ps(&bounds.max_x[j])),
+			_mm_cmpgt_ps(a_x2, _mm_loadu_ps(&bounds.min_x[j]))
+		) };
+		__m128 y{ _mm_and_ps(
+			_mm_cmplt_ps(a_y1, _mm_loadu_ps(&bounds.max_y[j])),
+			_mm_cmpgt_ps(a_y2, _mm_loadu_ps(&bounds.min_y[j]))
+		) };
+		return static_cast<unsigned>(_mm_movemask_ps(_mm_and_ps(x, y)));
+	};
+
+	std::size_t j{ first };
+	for (; j + 8 <= last; j += 8) {
+		unsigned mask{ test4(j) | (test4(j + 4) << 4) };
+		push_mask(mask, j, hits);
+	}
+	for (; j + 4 <= last; j += 4) {
+		push_mask(test4(j), j, hits);
+	}
+
+	overlap_scalar(bounds, x1, y1, x2, y2, j, last, hits);
+}
+
+#else
+
+void aabb_kernel::overlap(
+	const ColliderBounds& bounds,
+	float x1,
+	float y1,
+	float x2,
+	float y2,
+	std::size_t first,
+	std::size_t last,
+	std::vector<std::uint32_t>& hits
+) {
+	overlap_scalar(bounds, x1, y1, x2, y2, first, last, hits);
+}
+
+#endif
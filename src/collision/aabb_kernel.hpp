@@ -0,0 +1,67 @@
+#ifndef AABB_KERNEL_HPP
+#define AABB_KERNEL_HPP
+
+#include "collider_bounds.hpp"
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/*
+* Batched AABB overlap tests over ColliderBounds.
+* The implementation is picked at build time (see ENGINE_SIMD in CMakeLists.txt):
+* AVX2 tests 16 candidates per iteration, SSE2 tests 8, the scalar path tests 1.
+*/
+namespace aabb_kernel {
+
+	// Name of the kernel compiled into this build ("avx2", "sse2" or "scalar").
+	const char* name();
+
+	// Tests the box (x1, y1, x2, y2) against the candidates in [first, last) and
+	// appends the index of every overlapping candidate to 'hits' in ascending order.
+	void overlap(
+		const ColliderBounds& bounds,
+		float x1,
+		float y1,
+		float x2,
+		float y2,
+		std::size_t first,
+		std::size_t last,
+		std::vector<std::uint32_t>& hits
+	);
+
+	// Reference implementation, always available regardless of the build flags.
+	void overlap_scalar(
+		const ColliderBounds& bounds,
+		float x1,
+		float y1,
+		float x2,
+		float y2,
+		std::size_t first,
+		std::size_t last,
+		std::vector<std::uint32_t>& hits
+	);
+
+	// Same as above, using box 'index' of the bounds as the tested box.
+	inline void overlap(
+		const ColliderBounds& bounds,
+		std::size_t index,
+		std::size_t first,
+		std::size_t last,
+		std::vector<std::uint32_t>& hits
+	) {
+		overlap(bounds, bounds.min_x[index], bounds.min_y[index], bounds.max_x[index], bounds.max_y[index], first, last, hits);
+	}
+
+	inline void overlap_scalar(
+		const ColliderBounds& bounds,
+		std::size_t index,
+		std::size_t first,
+		std::size_t last,
+		std::vector<std::uint32_t>& hits
+	) {
+		overlap_scalar(bounds, bounds.min_x[index], bounds.min_y[index], bounds.max_x[index], bounds.max_y[index], first, last, hits);
+	}
+}
+
+#endif //AABB_KERNEL_HPP
@@ -0,0 +1,41 @@
+#ifndef COLLIDER_BOUNDS_HPP
+#define COLLIDER_BOUNDS_HPP
+
+#include <vector>
+#include <cstddef>
+
+/*
+* World space collider bounds stored as SoA float arrays,
+* gathered once per frame so the overlap kernel can stream them.
+*/
+struct ColliderBounds {
+	std::vector<float> min_x{};
+	std::vector<float> min_y{};
+	std::vector<float> max_x{};
+	std::vector<float> max_y{};
+
+	std::size_t size() const { return min_x.size(); }
+
+	void clear() {
+		min_x.clear();
+		min_y.clear();
+		max_x.clear();
+		max_y.clear();
+	}
+
+	void reserve(std::size_t size) {
+		min_x.reserve(size);
+		min_y.reserve(size);
+		max_x.reserve(size);
+		max_y.reserve(size);
+	}
+
+	void push_back(float x1, float y1, float x2, float y2) {
+		min_x.push_back(x1);
+		min_y.push_back(y1);
+		max_x.push_back(x2);
+		max_y.push_back(y2);
+	}
+};
+
+#endif //COLLIDER_BOUNDS_HPP
@@ -0,0 +1,71 @@
+#ifndef CONTACT_CACHE_HPP
+#define CONTACT_CACHE_HPP
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+/*
+* Remembers which entity pairs were touching, keyed by the sorted pair of ids
+* and stamped with the frame they were last seen in, so contacts can be reported
+* as transitions (begin / end) instead of once per frame.
+*/
+class ContactCache {
+public:
+	void begin_frame() { ++frame; }
+
+	// Marks the pair as touching this frame, returns true if the contact just began.
+	bool touch(int a, int b) {
+		auto [itr, inserted] { contacts.try_emplace(key(a, b), Contact{ a, b, frame }) };
+		itr->second.frame = frame;
+		return inserted;
+	}
+
+	// Removes the pairs that weren't touched this frame, calling on_end(a, b) for each one
+	// in (a, b) order, so the result doesn't depend on the layout of the hash map.
+	template <typename TFunction>
+	void end_frame(TFunction&& on_end) {
+		ended.clear();
+
+		for (auto itr{ contacts.begin() }; itr != contacts.end();) {
+			if (itr->second.frame != frame) {
+				ended.emplace_back(itr->second.a, itr->second.b);
+				itr = contacts.erase(itr);
+			}
+			else {
+				++itr;
+			}
+		}
+
+		std::sort(ended.begin(), ended.end());
+
+		for (const auto& [a, b] : ended) {
+			on_end(a, b);
+		}
+	}
+
+	std::size_t size() const { return contacts.size(); }
+	void clear() { contacts.clear(); }
+
+private:
+	struct Contact {
+		int a{};
+		int b{};
+		std::uint32_t frame{};
+	};
+
+	std::unordered_map<std::uint64_t, Contact> contacts{};
+	std::vector<std::pair<int, int>> ended{};
+	std::uint32_t frame{};
+
+	static std::uint64_t key(int a, int b) {
+		if (a > b) {
+			std::swap(a, b);
+		}
+		return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(a)) << 32) | static_cast<std::uint32_t>(b);
+	}
+};
+
+#endif //CONTACT_CACHE_HPP
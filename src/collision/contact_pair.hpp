@@ -0,0 +1,35 @@
+#ifndef CONTACT_PAIR_HPP
+#define CONTACT_PAIR_HPP
+
+#include "../ecs/ecs.hpp"
+
+#include <algorithm>
+#include <span>
+
+/*
+* One touching pair in the per-frame contact stream published by the CollisionSystem.
+* Pairs are ordered so that a_group <= b_group and the stream is sorted by group pair.
+*/
+struct ContactPair {
+	Entity a;
+	Entity b;
+	int a_group{ -1 };
+	int b_group{ -1 };
+	bool is_new{ false }; // the pair started touching this frame
+};
+
+namespace contact_pair {
+
+	inline bool group_less(const ContactPair& lhs, const ContactPair& rhs) {
+		return lhs.a_group < rhs.a_group || (lhs.a_group == rhs.a_group && lhs.b_group < rhs.b_group);
+	}
+
+	// Contacts between the two groups, in either order; the pair's 'a' belongs to min(group1, group2).
+	inline std::span<const ContactPair> between(std::span<const ContactPair> contacts, int group1, int group2) {
+		ContactPair key{ Entity{ -1, nullptr }, Entity{ -1, nullptr }, std::min(group1, group2), std::max(group1, group2) };
+		auto [first, last] { std::equal_range(contacts.begin(), contacts.end(), key, group_less) };
+		return { first, last };
+	}
+}
+
+#endif //CONTACT_PAIR_HPP
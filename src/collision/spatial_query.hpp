@@ -0,0 +1,27 @@
+#ifndef SPATIAL_QUERY_HPP
+#define SPATIAL_QUERY_HPP
+
+#include "../ecs/ecs.hpp"
+
+/*
+* Restricts spatial query results. The group is interned (Registry::intern_group),
+* a group_id of -1 matches every entity.
+*/
+struct SpatialQueryFilter {
+	int group_id{ -1 };
+	int exclude_id{ -1 };
+
+	bool accepts(const Entity& entity) const {
+		if (entity.get_id() == exclude_id) {
+			return false;
+		}
+		return group_id < 0 || entity.get_group_id() == group_id;
+	}
+};
+
+struct RaycastHit {
+	Entity entity;
+	double distance{};
+};
+
+#endif //SPATIAL_QUERY_HPP
@@ -0,0 +1,66 @@
+#ifndef SWEPT_AABB_HPP
+#define SWEPT_AABB_HPP
+
+#include <algorithm>
+#include <limits>
+
+/*
+* Box at the start of the step together with the distance it travelled during the step.
+*/
+struct SweptBox {
+	double x{};
+	double y{};
+	double width{};
+	double height{};
+	double dx{};
+	double dy{};
+};
+
+namespace swept_aabb {
+
+	// Returns true when the boxes touch at any time in [0, 1] of the step,
+	// 'time_of_impact' receives the first such time (0 if they start overlapping).
+	inline bool intersect(const SweptBox& a, const SweptBox& b, double& time_of_impact) {
+		constexpr double infinity{ std::numeric_limits<double>::infinity() };
+
+		// Move in b's frame of reference so only a is moving
+		const double vx{ a.dx - b.dx };
+		const double vy{ a.dy - b.dy };
+
+		double entry_x{ -infinity };
+		double exit_x{ infinity };
+		if (vx != 0.0) {
+			double t1{ (b.x - (a.x + a.width)) / vx };
+			double t2{ (b.x + b.width - a.x) / vx };
+			entry_x = std::min(t1, t2);
+			exit_x = std::max(t1, t2);
+		}
+		else if (a.x >= b.x + b.width || a.x + a.width <= b.x) {
+			return false;
+		}
+
+		double entry_y{ -infinity };
+		double exit_y{ infinity };
+		if (vy != 0.0) {
+			double t1{ (b.y - (a.y + a.height)) / vy };
+			double t2{ (b.y + b.height - a.y) / vy };
+			entry_y = std::min(t1, t2);
+			exit_y = std::max(t1, t2);
+		}
+		else if (a.y >= b.y + b.height || a.y + a.height <= b.y) {
+			return false;
+		}
+
+		const double entry{ std::max(entry_x, entry_y) };
+		const double exit{ std::min(exit_x, exit_y) };
+
+		if (entry >= exit || entry > 1.0 || exit <= 0.0) {
+			return false;
+		}
+
+		time_of_impact = std::max(entry, 0.0);
+		return true;
+	}
+}
+
+#endif //SWEPT_AABB_HPP
@@ -1,21 +1,25 @@
 #ifndef ANIMATION_COMPONENT_HPP
 #define ANIMATION_COMPONENT_HPP
 
+#include "../asset_manager/asset_handle.hpp"
+
+/*
+* The frames live in the shared AnimationClip, an entity only keeps where it is in it.
+*/
 struct AnimationComponent {
-	int frames{ 1 };
-	int current_frame{ 0 };
-	double frame_delay{ 0.0 };
-	double elapsed_seconds{ 0.0 };
-	bool loop{ true };
+	AnimationClipHandle clip{};
+	double time{ 0.0 };
+
+	AnimationComponent(AnimationClipHandle clip = {}, double time = 0.0) :
+		clip{ clip },
+		time{ time } {
+	}
 
-	AnimationComponent(
-		int frames = 1,
-		double frame_delay = 0.0,
-		bool loop = true
-	) :
-		frames{ frames },
-		frame_delay{ frame_delay },
-		loop{ loop } {
+	void play(AnimationClipHandle new_clip) {
+		if (new_clip.index != clip.index) {
+			clip = new_clip;
+			time = 0.0;
+		}
 	}
 };
 
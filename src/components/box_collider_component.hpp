@@ -8,15 +8,18 @@ struct BoxColliderComponent {
 	int height{ 0 };
 	glm::dvec2 offset{ 0.0, 0.0 };
 	bool is_colliding{ false };
+	bool is_continuous{ false }; // swept test against its motion, for fast movers like projectiles
 
 	BoxColliderComponent(
 		int width = 0,
 		int height = 0,
-		glm::dvec2 offset = glm::dvec2(0.0)
+		glm::dvec2 offset = glm::dvec2(0.0),
+		bool is_continuous = false
 	) :
 		width{ width },
 		height{ height },
-		offset{ offset } {
+		offset{ offset },
+		is_continuous{ is_continuous } {
 	}
 };
 
@@ -1,6 +1,8 @@
 #ifndef KEYBOARD_CONTROL_COMPONENT_HPP
 #define KEYBOARD_CONTROL_COMPONENT_HPP
 
+#include "../asset_manager/asset_handle.hpp"
+
 #include <glm/glm.hpp>	
 
 struct KeyboardControlComponent {
@@ -10,16 +12,30 @@ struct KeyboardControlComponent {
 	glm::dvec2 down_velocity{};
 	glm::dvec2 left_velocity{};
 
+	// Clips played when facing each direction, invalid ones fall back to the sprite row
+	AnimationClipHandle up_clip{};
+	AnimationClipHandle right_clip{};
+	AnimationClipHandle down_clip{};
+	AnimationClipHandle left_clip{};
+
 	KeyboardControlComponent(
 		glm::dvec2 up_velocity = { 0.0, 0.0 },
 		glm::dvec2 right_velocity = { 0.0, 0.0 },
 		glm::dvec2 down_velocity = { 0.0, 0.0 },
-		glm::dvec2 left_velocity = { 0.0, 0.0 }
+		glm::dvec2 left_velocity = { 0.0, 0.0 },
+		AnimationClipHandle up_clip = {},
+		AnimationClipHandle right_clip = {},
+		AnimationClipHandle down_clip = {},
+		AnimationClipHandle left_clip = {}
 	) :
 		up_velocity{ up_velocity },
 		right_velocity{ right_velocity },
 		down_velocity{ down_velocity },
-		left_velocity{ left_velocity }
+		left_velocity{ left_velocity },
+		up_clip{ up_clip },
+		right_clip{ right_clip },
+		down_clip{ down_clip },
+		left_clip{ left_clip }
 	{
 	}
 };
@@ -0,0 +1,69 @@
+#ifndef PARTICLE_EMITTER_COMPONENT_HPP
+#define PARTICLE_EMITTER_COMPONENT_HPP
+
+#include "../asset_manager/asset_handle.hpp"
+
+#include <glm/glm.hpp>
+
+/*
+* Spawns particles at the entity position, simulated and drawn by the ParticleSystem
+* without becoming entities. Particles show 'frames' frames of frame_width * frame_height
+* laid out horizontally in the texture, cycling at frame_rate frames per second.
+*/
+struct ParticleEmitterComponent {
+
+	TextureHandle texture{};
+	int frame_width{};
+	int frame_height{};
+	int frames{};
+	double frame_rate{};
+	double scale{};
+
+	double rate{};          // particles per second
+	int burst{};            // particles spawned at once when the emitter starts
+	double lifetime{};      // seconds, +/- lifetime_jitter
+	double lifetime_jitter{};
+	glm::dvec2 velocity{};  // +/- spread on both axes
+	double spread{};
+	glm::dvec2 offset{};
+	double duration{};      // seconds the emitter emits, < 0 for ever
+
+	double elapsed_seconds{};
+	double pending_particles{};
+	bool has_burst{};
+	int style{ -1 };        // resolved by the ParticleSystem
+
+	ParticleEmitterComponent(
+		TextureHandle texture = {},
+		int frame_width = 8,
+		int frame_height = 8,
+		int frames = 1,
+		double frame_rate = 10.0,
+		double scale = 1.0,
+		double rate = 10.0,
+		int burst = 0,
+		double lifetime = 1.0,
+		double lifetime_jitter = 0.0,
+		glm::dvec2 velocity = { 0.0, 0.0 },
+		double spread = 0.0,
+		glm::dvec2 offset = { 0.0, 0.0 },
+		double duration = -1.0
+	) :
+		texture{ texture },
+		frame_width{ frame_width },
+		frame_height{ frame_height },
+		frames{ frames },
+		frame_rate{ frame_rate },
+		scale{ scale },
+		rate{ rate },
+		burst{ burst },
+		lifetime{ lifetime },
+		lifetime_jitter{ lifetime_jitter },
+		velocity{ velocity },
+		spread{ spread },
+		offset{ offset },
+		duration{ duration } {
+	}
+};
+
+#endif //PARTICLE_EMITTER_COMPONENT_HPP
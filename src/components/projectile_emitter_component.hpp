@@ -1,6 +1,8 @@
 #ifndef PROJECTILE_EMITTER_COMPONENT_HPP
 #define PROJECTILE_EMITTER_COMPONENT_HPP
 
+#include "../asset_manager/asset_handle.hpp"
+
 #include <glm/glm.hpp>
 
 struct ProjectileEmitterComponent {
@@ -11,19 +13,22 @@ struct ProjectileEmitterComponent {
 	double duration{};
 	double elapsed_seconds{};
 	bool is_friendly{};
+	TextureHandle projectile_texture{};
 
 	ProjectileEmitterComponent(
 		glm::dvec2 velocity = { 50.0, 50.0 },
 		int damage = 10,
 		double emission_delay = 2.0,
 		double duration = 10.0,
-		bool is_friendly = false
+		bool is_friendly = false,
+		TextureHandle projectile_texture = {}
 	) :
 		velocity{ velocity },
 		damage{ damage },
 		emission_delay{ emission_delay },
 		duration{ duration },
-		is_friendly{ is_friendly } {
+		is_friendly{ is_friendly },
+		projectile_texture{ projectile_texture } {
 	}
 };
 
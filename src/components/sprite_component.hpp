@@ -1,9 +1,9 @@
 #ifndef SPRITE_COMPONENT_HPP
 #define SPRITE_COMPONENT_HPP
 
-#include <SDL2/SDL_rect.h>
+#include "../asset_manager/asset_handle.hpp"
 
-#include <string>
+#include <SDL2/SDL_rect.h>
 
 namespace sprite_config {
 	constexpr int src_x{ 0 };
@@ -13,7 +13,7 @@ namespace sprite_config {
 }
 
 struct SpriteComponent {
-	std::string asset_id{};
+	TextureHandle texture{};
 	int z_index{};
 	bool is_fixed{};
 	int width{ sprite_config::width };
@@ -27,7 +27,7 @@ struct SpriteComponent {
 	SDL_RendererFlip flip{SDL_FLIP_NONE};
 
 	SpriteComponent(
-		const std::string& asset_id = "",
+		TextureHandle texture = {},
 		int z_index = 0,
 		bool is_fixed = false,
 		int width = sprite_config::width,
@@ -35,7 +35,7 @@ struct SpriteComponent {
 		int src_x = sprite_config::src_x,
 		int src_y = sprite_config::src_y
 	) :
-		asset_id{ asset_id }, z_index{ z_index },
+		texture{ texture }, z_index{ z_index },
 		is_fixed{ is_fixed }, width{ width }, height{ height },
 		src_rect{ src_x, src_y, width, height }, flip{SDL_FLIP_NONE}
 	{
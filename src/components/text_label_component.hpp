@@ -1,6 +1,8 @@
 #ifndef TEXT_LABEL_COMPONENT_HPP
 #define TEXT_LABEL_COMPONENT_HPP
 
+#include "../asset_manager/asset_handle.hpp"
+
 #include <glm/glm.hpp>	
 #include <SDL2/SDL.h>
 
@@ -10,20 +12,20 @@ struct TextLabelComponent {
 
 	glm::ivec2 position{};
 	std::string text{};
-	std::string asset_id{};
+	FontHandle font{};
 	SDL_Color color{};
 	bool is_fixed{};
 
 	TextLabelComponent(
 		glm::ivec2 position = { 0, 0 },
 		std::string text = "Insert Text",
-		std::string asset_id = "arial",
+		FontHandle font = {},
 		SDL_Color color = { 255, 255, 255, 255 },
 		bool is_fixed = true
 	) :
 		position{ position },
 		text{ text },
-		asset_id{ asset_id },
+		font{ font },
 		color{ color },
 		is_fixed{ is_fixed }
 	{
@@ -5,6 +5,8 @@
 
 struct TransformComponent {
 	glm::dvec2 position{};
+	glm::dvec2 previous_position{};        // start of the last movement step, swept by continuous colliders
+	glm::dvec2 render_previous_position{}; // start of the last simulation step, drawing only
 	glm::dvec2 scale{ 1.0, 1.0 };
 	double rotation{};
 
@@ -12,7 +14,12 @@ struct TransformComponent {
 		glm::dvec2 position = glm::dvec2(0, 0),
 		glm::dvec2 scale = glm::dvec2(1.0, 1.0),
 		double rotation = 0.0)
-		: position{ position }, scale{ scale }, rotation{ rotation } {
+		: position{ position }, previous_position{ position }, render_previous_position{ position }, scale{ scale }, rotation{ rotation } {
+	}
+
+	// Where to draw between the last two simulation steps, alpha in [0, 1].
+	glm::dvec2 interpolate(double alpha) const {
+		return render_previous_position + (position - render_previous_position) * alpha;
 	}
 };
 
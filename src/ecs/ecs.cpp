@@ -29,9 +29,14 @@ bool Entity::belong_to_group(const std::string& s) const {
 	return registry->belong_to_group(*this, s);
 }
 
+int Entity::get_group_id() const {
+	return registry->get_group_id(*this);
+}
+
 
 void System::add_entity(const Entity& entity) {
 	entities.push_back(entity);
+	++entities_version;
 }
 
 void System::remove_entity(const Entity& entity) {
@@ -46,6 +51,7 @@ void System::remove_entity(const Entity& entity) {
 		),
 		entities.end()
 	);
+	++entities_version;
 }
 
 std::vector<Entity>& System::get_entities() {
@@ -122,6 +128,7 @@ Entity Registry::create_entity() {
 
 	if (id >= entity_component_signatures.size()) {
 		entity_component_signatures.resize(id + 1);
+		entity_group_ids.resize(id + 1, -1);
 	}
 
 	Logger::log("Registry: Entity created, id: " + std::to_string(entity.get_id()));
@@ -168,6 +175,7 @@ Entity Registry::get_entity_by_tag(const std::string& s) const {
 void Registry::add_group(const Entity& e, const std::string& s) {
 	group_entity[s].insert(e);
 	entity_group.insert({ e.get_id(), s });
+	entity_group_ids[static_cast<std::size_t>(e.get_id())] = intern_group(s);
 }
 
 void Registry::remove_group(const Entity& e) {
@@ -179,6 +187,7 @@ void Registry::remove_group(const Entity& e) {
 	std::string group{ entity_group[id] };
 	entity_group.erase(id);
 	group_entity[group].erase(e);
+	entity_group_ids[static_cast<std::size_t>(id)] = -1;
 }
 
 bool Registry::belong_to_group(const Entity& e, const std::string& s) const {
@@ -195,3 +204,12 @@ bool Registry::belong_to_group(const Entity& e, const std::string& s) const {
 std::set<Entity> Registry::get_entities_by_group(const std::string& s) const {
 	return group_entity.at(s);
 }
+
+int Registry::intern_group(const std::string& s) {
+	auto [itr, inserted] { group_ids.try_emplace(s, static_cast<int>(group_ids.size())) };
+	return itr->second;
+}
+
+int Registry::get_group_id(const Entity& e) const {
+	return entity_group_ids[static_cast<std::size_t>(e.get_id())];
+}
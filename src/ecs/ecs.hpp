@@ -40,6 +40,7 @@ public:
 	bool has_tag(const std::string& s) const;
 	void add_group(const std::string& s);
 	bool belong_to_group(const std::string& s) const;
+	int get_group_id() const;
 
 	template <typename TComponent, typename ...Args>
 	void add_component(Args&& ...args);
@@ -92,12 +93,16 @@ public:
 	std::vector<Entity>& get_entities();
 	const Signature& get_component_signature() const;
 
+	// Bumped whenever an entity is added or removed, lets systems cache data built from the entities.
+	std::uint32_t get_entities_version() const { return entities_version; }
+
 	template <typename TComponent>
 	void require_component();
 
 private:
 	Signature component_signature{};
 	std::vector<Entity> entities{};
+	std::uint32_t entities_version{};
 };
 
 class IPool {
@@ -155,6 +160,10 @@ public:
 	bool belong_to_group(const Entity& e, const std::string& s) const;
 	std::set<Entity> get_entities_by_group(const std::string& s) const;
 
+	// Groups are interned to dense ids, -1 means no group
+	int intern_group(const std::string& s);
+	int get_group_id(const Entity& e) const;
+
 	// Component managment
 	template <typename TComponent, typename ...Args>
 	void add_component(const Entity& entity, Args&& ...args);
@@ -193,6 +202,8 @@ private:
 	std::unordered_map<std::string, Entity> tag_entity{};
 	std::unordered_map<std::string, std::set<Entity>> group_entity{};
 	std::unordered_map<int, std::string> entity_group{};
+	std::unordered_map<std::string, int> group_ids{};
+	std::vector<int> entity_group_ids{};
 };
 
 template <typename TComponent, typename ...Args>
@@ -0,0 +1,103 @@
+#ifndef EVENT_CHANNEL_HPP
+#define EVENT_CHANNEL_HPP
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+class EventManager;
+
+class IEventChannel {
+public:
+	virtual ~IEventChannel() = default;
+
+	virtual void drain(EventManager& event_manager) = 0;
+};
+
+/*
+* Lets several threads produce events of one type without locks or per-event allocation.
+* Every producer owns a bounded single-producer ring (events are built in place), the main
+* thread drains the rings in producer order and each ring in push order, so the resulting
+* order doesn't depend on thread scheduling.
+*/
+template <typename TEvent>
+class EventChannel : public IEventChannel {
+public:
+	EventChannel(std::size_t producers, std::size_t capacity) :
+		producers{ producers },
+		capacity{ std::bit_ceil(capacity < 1 ? std::size_t{ 1 } : capacity) },
+		lanes{ std::make_unique<Lane[]>(producers) } {
+		for (std::size_t i{}; i < producers; ++i) {
+			lanes[i].slots = std::make_unique<Slot[]>(this->capacity);
+		}
+	}
+
+	~EventChannel() override {
+		consume([](TEvent&&) {});
+	}
+
+	EventChannel(const EventChannel&) = delete;
+	EventChannel& operator=(const EventChannel&) = delete;
+
+	std::size_t get_producers() const { return producers; }
+	std::size_t get_capacity() const { return capacity; }
+
+	// Only the thread currently owning the producer slot may push to it.
+	// Returns false when the ring of that producer is full.
+	template <typename ...Args>
+	bool try_push(std::size_t producer, Args&& ...args) {
+		Lane& lane{ lanes[producer] };
+
+		const std::size_t tail{ lane.tail.load(std::memory_order_relaxed) };
+		if (tail - lane.head.load(std::memory_order_acquire) == capacity) {
+			return false;
+		}
+
+		::new (static_cast<void*>(lane.slots[tail & (capacity - 1)].data)) TEvent{ std::forward<Args>(args)... };
+		lane.tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side, calls on_event(TEvent&&) for every published event.
+	template <typename TFunction>
+	void consume(TFunction&& on_event) {
+		for (std::size_t i{}; i < producers; ++i) {
+			Lane& lane{ lanes[i] };
+
+			std::size_t head{ lane.head.load(std::memory_order_relaxed) };
+			const std::size_t tail{ lane.tail.load(std::memory_order_acquire) };
+
+			for (; head != tail; ++head) {
+				TEvent* event{ std::launder(reinterpret_cast<TEvent*>(lane.slots[head & (capacity - 1)].data)) };
+				on_event(std::move(*event));
+				event->~TEvent();
+			}
+
+			lane.head.store(head, std::memory_order_release);
+		}
+	}
+
+	// Moves the events to the queue of the EventManager, see event_manager.hpp.
+	void drain(EventManager& event_manager) final override;
+
+private:
+	struct Slot {
+		alignas(TEvent) std::byte data[sizeof(TEvent)];
+	};
+
+	// Indices only grow, the producer and consumer ends live on separate cache lines
+	struct Lane {
+		alignas(64) std::atomic<std::size_t> head{};
+		alignas(64) std::atomic<std::size_t> tail{};
+		std::unique_ptr<Slot[]> slots{};
+	};
+
+	std::size_t producers{};
+	std::size_t capacity{};
+	std::unique_ptr<Lane[]> lanes{};
+};
+
+#endif //EVENT_CHANNEL_HPP
@@ -1,6 +1,29 @@
 #include "event_manager.hpp"
 
-IEventCallback::~IEventCallback() {}
+#include <algorithm>
+
+EventSubscription::EventSubscription(EventSubscription&& other) noexcept :
+	event_manager{ other.event_manager }, event_id{ other.event_id }, id{ other.id } {
+	other.event_manager = nullptr;
+}
+
+EventSubscription& EventSubscription::operator=(EventSubscription&& other) noexcept {
+	if (this != &other) {
+		reset();
+		event_manager = other.event_manager;
+		event_id = other.event_id;
+		id = other.id;
+		other.event_manager = nullptr;
+	}
+	return *this;
+}
+
+void EventSubscription::reset() {
+	if (event_manager) {
+		event_manager->unsubscribe(event_id, id);
+		event_manager = nullptr;
+	}
+}
 
 EventManager::EventManager() {
 	Logger::log("Event manager created!");
@@ -10,3 +33,66 @@ EventManager::~EventManager() {
 	Logger::log("Event manager destroyed!");
 }
 
+void EventManager::unsubscribe(int event_id, std::uint32_t id) {
+	const std::size_t event_index{ static_cast<std::size_t>(event_id) };
+	if (event_id < 0 || event_index >= handlers.size()) {
+		return;
+	}
+
+	EventHandlers& event_handlers{ handlers[event_index] };
+
+	auto remove = [this, id](auto& handler_list) {
+		for (auto& handler : handler_list) {
+			if (handler.id == id) {
+				handler.object = nullptr;
+				has_removed_handlers = true;
+			}
+		}
+	};
+
+	remove(event_handlers.any);
+	remove(event_handlers.batch);
+	for (auto& [key, handler_list] : event_handlers.scoped) {
+		remove(handler_list);
+	}
+
+	if (dispatch_depth == 0) {
+		compact();
+	}
+}
+
+void EventManager::compact() {
+	auto is_removed = [](const auto& handler) { return handler.object == nullptr; };
+
+	for (EventHandlers& event_handlers : handlers) {
+		std::erase_if(event_handlers.any, is_removed);
+		std::erase_if(event_handlers.batch, is_removed);
+		for (auto& [key, handler_list] : event_handlers.scoped) {
+			std::erase_if(handler_list, is_removed);
+		}
+		std::erase_if(event_handlers.scoped, [](const auto& bucket) { return bucket.second.empty(); });
+	}
+	has_removed_handlers = false;
+}
+
+void EventManager::dispatch_all() {
+	for (auto& channel : channels) {
+		if (channel) {
+			channel->drain(*this);
+		}
+	}
+
+	while (!pending.empty()) {
+		dispatch_order.swap(pending);
+		pending.clear();
+
+		for (int event_id : dispatch_order) {
+			queues[static_cast<std::size_t>(event_id)]->dispatch(*this);
+		}
+		dispatch_order.clear();
+	}
+
+	if (dispatch_depth == 0 && has_removed_handlers) {
+		compact();
+	}
+}
@@ -1,90 +1,414 @@
 #ifndef EVENT_MANAGER_HPP
 #define EVENT_MANAGER_HPP
 
+#include "event_channel.hpp"
 #include "../events/event.hpp"
 #include "../logger/logger.hpp"
 
+#include <array>
+#include <deque>
 #include <unordered_map>
-#include <list>
-#include <typeindex>
+#include <vector>
 #include <memory>
-#include <functional>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 
-class IEventCallback {
-public:
-	virtual ~IEventCallback() = 0;
+/*
+* Non-owning {object, thunk} pair, the thunk restores the owner and event types.
+*/
+struct EventDelegate {
+	using Thunk = void (*)(void* object, Event& event);
+
+	std::uint32_t id{};
+	void* object{ nullptr }; // null once unsubscribed, until compacted
+	Thunk thunk{ nullptr };
+};
 
-	void execute(Event& e) { call(e); }
+using EventHandlerList = std::vector<EventDelegate>;
 
-private:
-	virtual void call(Event& e) = 0;
+/*
+* Batch handlers receive all the queued events of a type at once.
+*/
+struct EventBatchDelegate {
+	using Thunk = void (*)(void* object, const void* events, std::size_t count);
+
+	std::uint32_t id{};
+	void* object{ nullptr }; // null once unsubscribed, until compacted
+	Thunk thunk{ nullptr };
 };
 
-template <typename TOwner, typename TEvent>
-class EventCallback : public IEventCallback {
+using EventBatchHandlerList = std::vector<EventBatchDelegate>;
 
-	using CallbackFunction = void (TOwner::*)(TEvent&);
+/*
+* Restricts a subscription to the events about one entity, or about entities of one
+* interned group. Only events exposing get_subjects() can be scoped.
+* Entity ids are recycled, an entity scope should be reset when its entity is freed.
+*/
+struct EventScope {
+	std::uint64_t key{};
 
-public:
-	EventCallback(
-		TOwner* owner_instance,
-		CallbackFunction callback_function
-	) :
-		owner_instance{ owner_instance },
-		callback_function{ callback_function } {
+	static EventScope entity(int entity_id) { return { (std::uint64_t{ 1 } << 32) | static_cast<std::uint32_t>(entity_id) }; }
+	static EventScope group(int group_id) { return { (std::uint64_t{ 2 } << 32) | static_cast<std::uint32_t>(group_id) }; }
+};
+
+/*
+* All the handlers of one event type. Scoped handlers are bucketed by scope key,
+* so an event only touches the buckets of its own subjects.
+*/
+struct EventHandlers {
+	EventHandlerList any{};
+	EventBatchHandlerList batch{};
+	std::unordered_map<std::uint64_t, EventHandlerList> scoped{};
+};
+
+template <auto Method>
+struct EventMethod;
+
+template <typename TOwner, typename TEvent, void (TOwner::* Method)(TEvent&)>
+struct EventMethod<Method> {
+	using Owner = TOwner;
+	using Type = TEvent;
+
+	static void invoke(void* object, Event& event) {
+		(static_cast<TOwner*>(object)->*Method)(static_cast<TEvent&>(event));
 	}
+};
 
-	~EventCallback() final override = default;
+template <auto Method>
+struct EventBatchMethod;
 
-	EventCallback(const EventCallback&) = delete;
-	EventCallback& operator=(const EventCallback&) = delete;
+template <typename TOwner, typename TEvent, void (TOwner::* Method)(std::span<const TEvent>)>
+struct EventBatchMethod<Method> {
+	using Owner = TOwner;
+	using Type = TEvent;
 
-private:
-	TOwner* owner_instance{};
-	CallbackFunction callback_function{};
+	static void invoke(void* object, const void* events, std::size_t count) {
+		(static_cast<TOwner*>(object)->*Method)(std::span<const TEvent>{ static_cast<const TEvent*>(events), count });
+	}
+};
+
+class EventManager;
+
+class IEventQueue {
+public:
+	virtual ~IEventQueue() = default;
+
+	virtual void dispatch(EventManager& event_manager) = 0;
+};
+
+/*
+* Events of one type queued during the frame. The two buffers are swapped on dispatch,
+* so events queued by handlers land in the other one, and both keep their capacity.
+*/
+template <typename TEvent>
+class EventQueue : public IEventQueue {
+public:
+	std::vector<TEvent> queued{};
+	std::vector<TEvent> dispatching{};
 
-	void call(Event& e) final override { std::invoke(callback_function, owner_instance, static_cast<TEvent&>(e)); }
+	void dispatch(EventManager& event_manager) final override;
 };
 
-using EventHandlerList = std::list<std::unique_ptr<IEventCallback>>;
+/*
+* Keeps a listener subscribed for as long as it is alive, unsubscribes on destruction.
+*/
+class EventSubscription {
+public:
+	EventSubscription() = default;
+	EventSubscription(EventManager* event_manager, int event_id, std::uint32_t id) :
+		event_manager{ event_manager }, event_id{ event_id }, id{ id } {
+	}
+	~EventSubscription() { reset(); }
+
+	EventSubscription(const EventSubscription&) = delete;
+	EventSubscription& operator=(const EventSubscription&) = delete;
+	EventSubscription(EventSubscription&& other) noexcept;
+	EventSubscription& operator=(EventSubscription&& other) noexcept;
 
+	void reset();
+	bool is_active() const { return event_manager != nullptr; }
+
+private:
+	EventManager* event_manager{ nullptr };
+	int event_id{ -1 };
+	std::uint32_t id{};
+};
+
+/*
+* Listeners subscribe once and stay registered until their EventSubscription is destroyed.
+* Handlers are indexed by the dense EventType<T>::get_id(), each type owning a flat delegate array.
+* emit dispatches immediately, enqueue defers the event to dispatch_all where batch handlers
+* get the whole span of a type once, followed by the per-event handlers.
+* Worker threads produce through channels, which dispatch_all drains into the queues first.
+*/
 class EventManager {
 public:
 	EventManager();
 	~EventManager();
 
-	void reset() { listeners.clear(); }
+	EventManager(const EventManager&) = delete;
+	EventManager& operator=(const EventManager&) = delete;
+
+	void reset() { handlers.clear(); }
+
+	// Usage: event_manager.listen<&MovementSystem::on_tile_collision>(this);
+	template <auto Method>
+	[[nodiscard]] EventSubscription listen(typename EventMethod<Method>::Owner* owner_instance);
+
+	// Usage: event_manager.listen<&MovementSystem::on_enemy_tile_collision>(this, EventScope::group(enemies));
+	template <auto Method>
+	[[nodiscard]] EventSubscription listen(typename EventMethod<Method>::Owner* owner_instance, EventScope scope);
 
-	template <typename TOwner, typename TEvent>
-	void listen(TOwner* owner_instance, void (TOwner::* callback_function)(TEvent&));
+	// Usage: event_manager.listen_batch<&MovementSystem::on_tile_collisions>(this);
+	template <auto Method>
+	[[nodiscard]] EventSubscription listen_batch(typename EventBatchMethod<Method>::Owner* owner_instance);
+
+	void unsubscribe(int event_id, std::uint32_t id);
 
 	template<typename TEvent, typename ...Args>
 	void emit(Args&& ...args);
 
+	template<typename TEvent, typename ...Args>
+	void enqueue(Args&& ...args);
+
+	// Called on the main thread while no producer is pushing. An open channel is reused if it's
+	// big enough, otherwise its events are moved to the queue and it's replaced by a bigger one.
+	template<typename TEvent>
+	EventChannel<TEvent>& open_channel(std::size_t producers, std::size_t capacity);
+
+	// Dispatches the queued events by type, in the order types were first queued.
+	// Events queued by handlers are dispatched in a following round before returning.
+	void dispatch_all();
+
 private:
-	std::unordered_map<std::type_index, std::unique_ptr<EventHandlerList>> listeners{};
+	template <typename> friend class EventQueue;
+
+	// A deque so the handlers of a type stay in place when later types are added mid-dispatch
+	std::deque<EventHandlers> handlers{};
+	std::vector<std::unique_ptr<IEventQueue>> queues{};
+	std::vector<std::unique_ptr<IEventChannel>> channels{};
+	std::vector<int> pending{};
+	std::vector<int> dispatch_order{};
+	std::uint32_t next_id{ 1 };
+	int dispatch_depth{};
+	bool has_removed_handlers{ false };
+
+	void compact();
+
+	template<typename TEvent>
+	EventHandlers& get_handlers();
+
+	template<typename TEvent>
+	void dispatch_events(std::span<TEvent> events);
+
+	template<typename TEvent>
+	void deliver(EventHandlers& event_handlers, TEvent& event);
+
+	template<typename TEvent>
+	static void invoke(EventHandlerList& handler_list, TEvent& event);
 };
 
-template <typename TOwner, typename TEvent>
-void EventManager::listen(TOwner* owner_instance, void (TOwner::* callback_function)(TEvent&)) {
+template<typename TEvent>
+EventHandlers& EventManager::get_handlers() {
+	const std::size_t event_index{ static_cast<std::size_t>(EventType<TEvent>::get_id()) };
 
-	if (!listeners[typeid(TEvent)]) {
-		listeners[typeid(TEvent)] = std::make_unique<EventHandlerList>();
+	if (event_index >= handlers.size()) {
+		handlers.resize(event_index + 1);
 	}
 
-	auto listener{ std::make_unique<EventCallback<TOwner, TEvent>>(owner_instance, callback_function) };
-	listeners[typeid(TEvent)]->push_back(std::move(listener));
+	return handlers[event_index];
+}
+
+template <auto Method>
+EventSubscription EventManager::listen(typename EventMethod<Method>::Owner* owner_instance) {
+	using TEvent = typename EventMethod<Method>::Type;
+
+	const std::uint32_t id{ next_id++ };
+	get_handlers<TEvent>().any.push_back({ id, owner_instance, &EventMethod<Method>::invoke });
+
+	return EventSubscription{ this, EventType<TEvent>::get_id(), id };
+}
+
+template <auto Method>
+EventSubscription EventManager::listen(typename EventMethod<Method>::Owner* owner_instance, EventScope scope) {
+	using TEvent = typename EventMethod<Method>::Type;
+
+	static_assert(requires(const TEvent& event) { event.get_subjects(); }, "Only events exposing get_subjects() can be scoped");
+
+	const std::uint32_t id{ next_id++ };
+	get_handlers<TEvent>().scoped[scope.key].push_back({ id, owner_instance, &EventMethod<Method>::invoke });
+
+	return EventSubscription{ this, EventType<TEvent>::get_id(), id };
+}
+
+template <auto Method>
+EventSubscription EventManager::listen_batch(typename EventBatchMethod<Method>::Owner* owner_instance) {
+	using TEvent = typename EventBatchMethod<Method>::Type;
+
+	const std::uint32_t id{ next_id++ };
+	get_handlers<TEvent>().batch.push_back({ id, owner_instance, &EventBatchMethod<Method>::invoke });
+
+	return EventSubscription{ this, EventType<TEvent>::get_id(), id };
 }
 
 template<typename TEvent, typename ...Args>
 void EventManager::emit(Args&& ...args) {
-	EventHandlerList* handlers = listeners[typeid(TEvent)].get();
+	const std::size_t event_index{ static_cast<std::size_t>(EventType<TEvent>::get_id()) };
+
+	if (event_index >= handlers.size()) {
+		return;
+	}
+
+	EventHandlers& event_handlers{ handlers[event_index] };
+	if (event_handlers.any.empty() && event_handlers.scoped.empty()) {
+		return;
+	}
+
+	// Built once and shared by all the handlers
+	TEvent event{ std::forward<Args>(args)... };
+
+	++dispatch_depth;
+	deliver(event_handlers, event);
+	--dispatch_depth;
+
+	if (dispatch_depth == 0 && has_removed_handlers) {
+		compact();
+	}
+}
+
+template<typename TEvent, typename ...Args>
+void EventManager::enqueue(Args&& ...args) {
+	const int event_id{ EventType<TEvent>::get_id() };
+	const std::size_t event_index{ static_cast<std::size_t>(event_id) };
+
+	if (event_index >= queues.size()) {
+		queues.resize(event_index + 1);
+	}
+	if (!queues[event_index]) {
+		queues[event_index] = std::make_unique<EventQueue<TEvent>>();
+	}
+
+	auto& queue{ static_cast<EventQueue<TEvent>&>(*queues[event_index]) };
+	if (queue.queued.empty()) {
+		pending.push_back(event_id);
+	}
+	queue.queued.emplace_back(std::forward<Args>(args)...);
+}
+
+template<typename TEvent>
+EventChannel<TEvent>& EventManager::open_channel(std::size_t producers, std::size_t capacity) {
+	const std::size_t event_index{ static_cast<std::size_t>(EventType<TEvent>::get_id()) };
+
+	if (event_index >= channels.size()) {
+		channels.resize(event_index + 1);
+	}
+
+	auto* channel{ static_cast<EventChannel<TEvent>*>(channels[event_index].get()) };
+	if (channel && channel->get_producers() >= producers && channel->get_capacity() >= capacity) {
+		return *channel;
+	}
+
+	if (channel) {
+		channel->drain(*this);
+	}
+	channels[event_index] = std::make_unique<EventChannel<TEvent>>(producers, capacity);
+
+	return static_cast<EventChannel<TEvent>&>(*channels[event_index]);
+}
+
+template<typename TEvent>
+void EventChannel<TEvent>::drain(EventManager& event_manager) {
+	consume([&event_manager](TEvent&& event) { event_manager.enqueue<TEvent>(std::move(event)); });
+}
+
+template<typename TEvent>
+void EventQueue<TEvent>::dispatch(EventManager& event_manager) {
+	dispatching.swap(queued);
+	queued.clear();
+
+	event_manager.dispatch_events<TEvent>(dispatching);
+}
+
+template<typename TEvent>
+void EventManager::dispatch_events(std::span<TEvent> events) {
+	const std::size_t event_index{ static_cast<std::size_t>(EventType<TEvent>::get_id()) };
+
+	if (event_index >= handlers.size()) {
+		return;
+	}
+
+	EventHandlers& event_handlers{ handlers[event_index] };
+
+	++dispatch_depth;
+
+	const std::size_t count{ event_handlers.batch.size() };
+	for (std::size_t i{}; i < count; ++i) {
+		const EventBatchDelegate handler{ event_handlers.batch[i] };
+		if (handler.object) {
+			handler.thunk(handler.object, events.data(), events.size());
+		}
+	}
+
+	if (!event_handlers.any.empty() || !event_handlers.scoped.empty()) {
+		for (TEvent& event : events) {
+			deliver(event_handlers, event);
+		}
+	}
+
+	--dispatch_depth;
+}
+
+template<typename TEvent>
+void EventManager::deliver(EventHandlers& event_handlers, TEvent& event) {
+	invoke(event_handlers.any, event);
+
+	if constexpr (requires { event.get_subjects(); }) {
+		if (event_handlers.scoped.empty()) {
+			return;
+		}
+
+		// Each matching bucket is visited once, even when several subjects share it
+		const auto subjects{ event.get_subjects() };
+		std::array<std::uint64_t, 2 * std::tuple_size_v<decltype(subjects)>> keys{};
+		std::size_t key_count{};
+
+		auto add_key = [&keys, &key_count](EventScope scope) {
+			for (std::size_t i{}; i < key_count; ++i) {
+				if (keys[i] == scope.key) {
+					return;
+				}
+			}
+			keys[key_count++] = scope.key;
+		};
+
+		for (const auto& subject : subjects) {
+			add_key(EventScope::entity(subject.get_id()));
+			if (subject.get_group_id() >= 0) {
+				add_key(EventScope::group(subject.get_group_id()));
+			}
+		}
+
+		for (std::size_t i{}; i < key_count; ++i) {
+			auto itr{ event_handlers.scoped.find(keys[i]) };
+			if (itr != event_handlers.scoped.end()) {
+				invoke(itr->second, event);
+			}
+		}
+	}
+}
+
+// Handlers subscribed during dispatch only receive the next events,
+// indexing (not iterators) keeps this valid if the array reallocates.
+template<typename TEvent>
+void EventManager::invoke(EventHandlerList& handler_list, TEvent& event) {
+	const std::size_t count{ handler_list.size() };
 
-	if (handlers) {
-		for (auto itr{ handlers->begin() }; itr != handlers->end(); ++itr) {
-			IEventCallback* handler{ itr->get() };
-			TEvent event{ std::forward<Args>(args)... };
-			handler->execute(event);
+	for (std::size_t i{}; i < count; ++i) {
+		const EventDelegate handler{ handler_list[i] };
+		if (handler.object) {
+			handler.thunk(handler.object, event);
 		}
 	}
 }
@@ -0,0 +1,92 @@
+#include "event_recorder.hpp"
+
+#include "../logger/logger.hpp"
+
+bool EventRecorder::open(const std::string& path, int level) {
+	file.open(path, std::ios::binary | std::ios::trunc);
+
+	if (!file) {
+		Logger::err("Failed to open event log for recording at path: " + path);
+		return false;
+	}
+
+	write(event_log::magic);
+	write(event_log::version);
+	write(static_cast<std::int32_t>(level));
+
+	Logger::log("Recording events to: " + path);
+	return true;
+}
+
+void EventRecorder::listen_to_event(EventManager& event_manager) {
+	key_pressed_subscription = event_manager.listen<&EventRecorder::on_key_pressed>(this);
+}
+
+void EventRecorder::on_key_pressed(KeyPressedEvent& event) {
+	write(event_log::Record::KeyPressed);
+	write(static_cast<std::int32_t>(event.key));
+}
+
+void EventRecorder::record_frame(double delta_time, std::uint32_t ticks) {
+	write(event_log::Record::Frame);
+	write(frame++);
+	write(delta_time);
+	write(ticks);
+}
+
+bool EventReplayer::open(const std::string& path) {
+	file.open(path, std::ios::binary);
+
+	if (!file) {
+		Logger::err("Failed to open event log for replay at path: " + path);
+		return false;
+	}
+
+	std::uint32_t magic{};
+	std::uint32_t version{};
+	std::int32_t recorded_level{};
+
+	if (!read(magic) || !read(version) || !read(recorded_level) ||
+		magic != event_log::magic || version != event_log::version) {
+		Logger::err("Invalid or unsupported event log: " + path);
+		return false;
+	}
+
+	level = recorded_level;
+
+	Logger::log("Replaying events from: " + path);
+	return true;
+}
+
+bool EventReplayer::next_frame(ReplayFrame& replay_frame) {
+	replay_frame.keys.clear();
+
+	event_log::Record record{};
+	while (read(record)) {
+		switch (record) {
+		case event_log::Record::KeyPressed: {
+			std::int32_t key{};
+			if (!read(key)) {
+				break;
+			}
+			replay_frame.keys.push_back(static_cast<SDL_Keycode>(key));
+			continue;
+		}
+
+		case event_log::Record::Frame:
+			if (read(replay_frame.frame) && read(replay_frame.delta_time) && read(replay_frame.ticks)) {
+				if (replay_frame.frame != frame++) {
+					Logger::err("Event log frames are out of sequence at frame " + std::to_string(replay_frame.frame));
+				}
+				return true;
+			}
+			break;
+		}
+
+		Logger::err("Truncated or corrupted event log at frame " + std::to_string(frame));
+		return false;
+	}
+
+	Logger::log("Replay finished after " + std::to_string(frame) + " frames");
+	return false;
+}
@@ -0,0 +1,73 @@
+#ifndef EVENT_RECORDER_HPP
+#define EVENT_RECORDER_HPP
+
+#include "event_manager.hpp"
+#include "../events/key_pressed_event.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+* Binary log of the inputs of a session, in host byte order:
+* a header (magic, version, level), then for every frame the key presses emitted
+* during its input step followed by a frame record with its timing.
+* Everything else (collisions, scripts, damage...) is derived from these, so
+* replaying the log on the same level scripts reproduces the session.
+*/
+namespace event_log {
+	constexpr std::uint32_t magic{ 0x524C4547 }; // "GELR"
+	constexpr std::uint32_t version{ 2 }; // 2: fixed simulation steps
+
+	enum class Record : std::uint8_t {
+		KeyPressed = 1, // int32 key
+		Frame = 2       // uint32 frame, double delta_time, uint32 ticks
+	};
+}
+
+struct ReplayFrame {
+	std::uint32_t frame{};
+	double delta_time{};
+	std::uint32_t ticks{};
+	std::vector<SDL_Keycode> keys{};
+};
+
+class EventRecorder {
+public:
+	bool open(const std::string& path, int level);
+
+	// Records the KeyPressedEvents emitted through the event manager
+	void listen_to_event(EventManager& event_manager);
+	void on_key_pressed(KeyPressedEvent& event);
+
+	void record_frame(double delta_time, std::uint32_t ticks);
+
+private:
+	std::ofstream file{};
+	std::uint32_t frame{};
+	EventSubscription key_pressed_subscription{};
+
+	template <typename T>
+	void write(const T& value) { file.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+};
+
+class EventReplayer {
+public:
+	bool open(const std::string& path);
+
+	int get_level() const { return level; }
+
+	// Reads the key presses and timing of the next frame, false at the end of the log.
+	bool next_frame(ReplayFrame& replay_frame);
+
+private:
+	std::ifstream file{};
+	int level{ 1 };
+	std::uint32_t frame{};
+
+	template <typename T>
+	bool read(T& value) { return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T))); }
+};
+
+#endif //EVENT_RECORDER_HPP
@@ -0,0 +1,26 @@
+#ifndef ANIMATION_EVENT_HPP
+#define ANIMATION_EVENT_HPP
+
+#include "event.hpp"
+#include "../asset_manager/asset_handle.hpp"
+#include "../ecs/ecs.hpp"
+
+#include <array>
+
+/*
+* Emitted when the playback of an entity reaches an event of its clip,
+* 'event' indexes AnimationClip::events.
+*/
+class AnimationEvent : public Event {
+public:
+	Entity entity;
+	AnimationClipHandle clip;
+	int event;
+
+	AnimationEvent(Entity entity, AnimationClipHandle clip, int event) : entity{ entity }, clip{ clip }, event{ event } {}
+	~AnimationEvent() final override = default;
+
+	std::array<Entity, 1> get_subjects() const { return { entity }; }
+};
+
+#endif //ANIMATION_EVENT_HPP
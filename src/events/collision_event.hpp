@@ -4,13 +4,20 @@
 #include "event.hpp"
 #include "../ecs/ecs.hpp"
 
+#include <array>
+
+/*
+* Emitted once when two entities start overlapping.
+*/
 class CollisionEvent : public Event {
 public:
-	Entity& a;
-	Entity& b;
+	Entity a;
+	Entity b;
 
-	CollisionEvent(Entity& a, Entity& b) : a{ a }, b{ b } {}
+	CollisionEvent(Entity a, Entity b) : a{ a }, b{ b } {}
 	~CollisionEvent() final override = default;
+
+	std::array<Entity, 2> get_subjects() const { return { a, b }; }
 };
 
 #endif //COLLISION_EVENT_HPP
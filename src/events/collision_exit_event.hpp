@@ -0,0 +1,24 @@
+#ifndef COLLISION_EXIT_EVENT_HPP
+#define COLLISION_EXIT_EVENT_HPP
+
+#include "event.hpp"
+#include "../ecs/ecs.hpp"
+
+#include <array>
+
+/*
+* Emitted once when two entities stop overlapping.
+* Not emitted when the contact ends because one of them was destroyed.
+*/
+class CollisionExitEvent : public Event {
+public:
+	Entity a;
+	Entity b;
+
+	CollisionExitEvent(Entity a, Entity b) : a{ a }, b{ b } {}
+	~CollisionExitEvent() final override = default;
+
+	std::array<Entity, 2> get_subjects() const { return { a, b }; }
+};
+
+#endif //COLLISION_EXIT_EVENT_HPP
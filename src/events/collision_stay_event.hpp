@@ -0,0 +1,23 @@
+#ifndef COLLISION_STAY_EVENT_HPP
+#define COLLISION_STAY_EVENT_HPP
+
+#include "event.hpp"
+#include "../ecs/ecs.hpp"
+
+#include <array>
+
+/*
+* Emitted every frame after the first one while two entities keep overlapping.
+*/
+class CollisionStayEvent : public Event {
+public:
+	Entity a;
+	Entity b;
+
+	CollisionStayEvent(Entity a, Entity b) : a{ a }, b{ b } {}
+	~CollisionStayEvent() final override = default;
+
+	std::array<Entity, 2> get_subjects() const { return { a, b }; }
+};
+
+#endif //COLLISION_STAY_EVENT_HPP
@@ -9,4 +9,19 @@ public:
 
 inline Event::~Event() {}
 
+struct IEventType {
+protected:
+	inline static int next_id{};
+};
+
+// Dense per-type id, used by the EventManager to index its handler arrays
+template <typename TEvent>
+class EventType : public IEventType {
+public:
+	static int get_id() {
+		static const int id = next_id++;
+		return id;
+	}
+};
+
 #endif //EVENT
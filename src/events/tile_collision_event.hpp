@@ -0,0 +1,24 @@
+#ifndef TILE_COLLISION_EVENT_HPP
+#define TILE_COLLISION_EVENT_HPP
+
+#include "event.hpp"
+#include "../ecs/ecs.hpp"
+
+#include <array>
+
+/*
+* Emitted once when a moving collider starts overlapping a solid tile of the tilemap.
+*/
+class TileCollisionEvent : public Event {
+public:
+	Entity entity;
+	int col{};
+	int row{};
+
+	TileCollisionEvent(Entity entity, int col, int row) : entity{ entity }, col{ col }, row{ row } {}
+	~TileCollisionEvent() final override = default;
+
+	std::array<Entity, 1> get_subjects() const { return { entity }; }
+};
+
+#endif //TILE_COLLISION_EVENT_HPP
@@ -8,8 +8,10 @@
 #include "../systems/camera_movement_system.hpp"
 #include "../systems/collision_system.hpp"
 #include "../systems/damage_system.hpp"
+#include "../systems/interpolation_system.hpp"
 #include "../systems/keyboard_control_system.hpp"
 #include "../systems/movement_system.hpp"
+#include "../systems/particle_system.hpp"
 #include "../systems/projectile_duration_system.hpp"
 #include "../systems/projectile_emit_system.hpp"
 #include "../systems/render_collision_system.hpp"
@@ -23,6 +25,8 @@
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+
 #include <imgui/imgui.h>
 #include <imgui/imgui_impl_sdl2.h>
 #include <imgui/imgui_impl_sdlrenderer2.h>
@@ -35,9 +39,14 @@ int Game::map_height{};
 Game::Game()
 {
 	is_running = false;
+	event_manager = std::make_unique<EventManager>();
 	registry = std::make_unique<Registry>();
 	asset_manager = std::make_unique<AssetManager>();
-	event_manager = std::make_unique<EventManager>();
+	thread_pool = std::make_unique<ThreadPool>();
+	tilemap = std::make_unique<Tilemap>();
+	sprite_batch = std::make_unique<SpriteBatch>();
+	tilemap_renderer = std::make_unique<TilemapRenderer>();
+	simulation_thread = std::make_unique<WorkerThread>();
 	Logger::log("Game constructor called!");
 }
 
@@ -45,8 +54,17 @@ Game::~Game() {
 	Logger::log("Game destructor called!");
 }
 
-void Game::init() {
-	if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
+void Game::init(const GameConfig& config) {
+	is_headless = config.headless;
+
+	// Headless runs need no display, the frames only go to an offscreen surface
+	if (is_headless) {
+		SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+	}
+
+	const Uint32 subsystems{ is_headless ? SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_EVENTS : SDL_INIT_EVERYTHING };
+
+	if (SDL_Init(subsystems) != 0) {
 		std::string err(SDL_GetError());
 		Logger::err("Failed to initialize SDL: SDL Error: " + err);
 		return;
@@ -65,6 +83,36 @@ void Game::init() {
 	window_width = 800;
 	window_height = 600;
 
+	if (is_headless) {
+		if (!init_headless_renderer()) {
+			return;
+		}
+
+		if (!config.dump_dir.empty() || !config.golden_dir.empty()) {
+			frame_capture = std::make_unique<FrameCapture>(config.dump_dir, config.golden_dir);
+		}
+	}
+	else {
+		if (!config.dump_dir.empty() || !config.golden_dir.empty()) {
+			Logger::err("Frames can only be dumped or compared in headless mode");
+		}
+
+		if (!init_window_renderer()) {
+			return;
+		}
+	}
+
+	// Initialize the camera view with the entire screen area.
+	// Division by 2 is if SDL_RenderSetScale() above.
+	camera.x = 0;
+	camera.y = 0;
+	camera.w = window_width;
+	camera.h = window_height;
+
+	is_running = true;
+}
+
+bool Game::init_window_renderer() {
 	window = SDL_CreateWindow(
 		nullptr,
 		SDL_WINDOWPOS_CENTERED,
@@ -77,19 +125,19 @@ void Game::init() {
 	if (window == nullptr) {
 		std::string err{ SDL_GetError() };
 		Logger::err("Failed to create window: SDL Error: " + err);
-		return;
+		return false;
 	}
 
 	renderer = SDL_CreateRenderer(
 		window,
 		-1,
-		SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
+		SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_TARGETTEXTURE
 	);
 
 	if (renderer == nullptr) {
 		std::string err{ SDL_GetError() };
 		Logger::err("Failed to create renderer: SDL Error: " + err);
-		return;
+		return false;
 	}
 	//SDL_SetWindowFullscreen(window, SDL_WINDOW_FULLSCREEN_DESKTOP);
 	//SDL_RenderSetScale(renderer, 2.0f, 2.0f);
@@ -106,22 +154,88 @@ void Game::init() {
 	ImGui_ImplSDL2_InitForSDLRenderer(window, renderer);
 	ImGui_ImplSDLRenderer2_Init(renderer);
 
-	// Initialize the camera view with the entire screen area.
-	// Division by 2 is if SDL_RenderSetScale() above.
-	camera.x = 0;
-	camera.y = 0;
-	camera.w = window_width;
-	camera.h = window_height;
+	return true;
+}
 
-	is_running = true;
+bool Game::init_headless_renderer() {
+	headless_surface = SDL_CreateRGBSurfaceWithFormat(0, window_width, window_height, 32, SDL_PIXELFORMAT_RGBA32);
+
+	if (headless_surface == nullptr) {
+		std::string err{ SDL_GetError() };
+		Logger::err("Failed to create headless surface: SDL Error: " + err);
+		return false;
+	}
+
+	renderer = SDL_CreateSoftwareRenderer(headless_surface);
+
+	if (renderer == nullptr) {
+		std::string err{ SDL_GetError() };
+		Logger::err("Failed to create software renderer: SDL Error: " + err);
+		return false;
+	}
+
+	Logger::log("Running headless with the software renderer");
+	return true;
 }
 
-void Game::run(int level) {
+void Game::run(const GameConfig& config) {
+	int level{ config.level };
+
+	if (!config.replay_path.empty()) {
+		replayer = std::make_unique<EventReplayer>();
+		if (!replayer->open(config.replay_path)) {
+			return;
+		}
+		level = replayer->get_level();
+	}
+
 	setup(level);
+
+	if (!config.record_path.empty()) {
+		recorder = std::make_unique<EventRecorder>();
+		if (recorder->open(config.record_path, level)) {
+			recorder->listen_to_event(*event_manager);
+		}
+		else {
+			recorder.reset();
+		}
+	}
+
+	// The first frame shows the state right after loading
+	record_snapshot(snapshots[front_snapshot]);
+
+	// Loading time isn't simulated
+	millisecs_prev_frame = SDL_GetTicks();
+	counter_prev_frame = SDL_GetPerformanceCounter();
+
 	while (is_running) {
 		input();
-		update();
-		render();
+		if (!is_running) break;
+
+		// The next frame is simulated on the worker while this one is drawn,
+		// input and SDL rendering have to stay on the main thread
+		RenderSnapshot& next_snapshot{ snapshots[1 - front_snapshot] };
+		simulation_thread->start([this, &next_snapshot] {
+			update();
+			record_snapshot(next_snapshot);
+		});
+
+		render(snapshots[front_snapshot]);
+		simulation_thread->wait();
+		present();
+
+		front_snapshot = 1 - front_snapshot;
+
+		if (config.frames > 0 && static_cast<int>(frame) >= config.frames) {
+			is_running = false;
+		}
+	}
+
+	if (frame_capture && frame_capture->get_compared_frames() > 0) {
+		Logger::log(
+			"Golden comparison: " + std::to_string(frame_capture->get_mismatched_frames()) + " of " +
+			std::to_string(frame_capture->get_compared_frames()) + " frames differ"
+		);
 	}
 }
 
@@ -131,8 +245,10 @@ void Game::setup(int level) {
 	registry->add_system<CameraMovementSystem>();
 	registry->add_system<CollisionSystem>();
 	registry->add_system<DamageSystem>();
+	registry->add_system<InterpolationSystem>();
 	registry->add_system<KeyboarControlSystem>();
 	registry->add_system<MovementSystem>();
+	registry->add_system<ParticleSystem>();
 	registry->add_system<RenderSystem>();
 	registry->add_system<RenderHealthSystem>();
 	registry->add_system<RenderTextSystem>();
@@ -142,26 +258,32 @@ void Game::setup(int level) {
 	registry->add_system<ProjectileEmitSystem>();
 	registry->add_system<ScriptSystem>();
 
+	// Subscriptions live as long as the systems that own them
+	registry->get_system<MovementSystem>().listen_to_event(*event_manager, *registry);
+	registry->get_system<KeyboarControlSystem>().listen_to_event(*event_manager);
+
 	// Creating Lua bindings
-	registry->get_system<ScriptSystem>().create_lua_bindings(lua);
+	registry->get_system<ScriptSystem>().create_lua_bindings(lua, *registry, registry->get_system<CollisionSystem>(), *asset_manager);
 
 	LevelLoader loader{};
 	lua.open_libraries(sol::lib::base, sol::lib::math, sol::lib::os);
-	loader.load_level(lua, renderer, registry.get(), asset_manager.get(), level);
+	loader.load_level(lua, renderer, registry.get(), asset_manager.get(), tilemap.get(), level);
 }
 
 void Game::input() {
 	SDL_Event event;
 	while (SDL_PollEvent(&event)) {
 		//ImGui SDL input
-		ImGui_ImplSDL2_ProcessEvent(&event);
-		ImGuiIO& io{ ImGui::GetIO() };
-
-		int mouse_x, mouse_y;
-		const Uint32 buttons{ SDL_GetMouseState(&mouse_x, &mouse_y) };
-		io.MousePos = ImVec2(static_cast<float>(mouse_x), static_cast<float>(mouse_y));
-		io.MouseDown[0] = buttons & SDL_BUTTON(SDL_BUTTON_LEFT);
-		io.MouseDown[1] = buttons & SDL_BUTTON(SDL_BUTTON_RIGHT);
+		if (!is_headless) {
+			ImGui_ImplSDL2_ProcessEvent(&event);
+			ImGuiIO& io{ ImGui::GetIO() };
+
+			int mouse_x, mouse_y;
+			const Uint32 buttons{ SDL_GetMouseState(&mouse_x, &mouse_y) };
+			io.MousePos = ImVec2(static_cast<float>(mouse_x), static_cast<float>(mouse_y));
+			io.MouseDown[0] = buttons & SDL_BUTTON(SDL_BUTTON_LEFT);
+			io.MouseDown[1] = buttons & SDL_BUTTON(SDL_BUTTON_RIGHT);
+		}
 
 		//Handle core SDL event
 		switch (event.type) {
@@ -173,63 +295,143 @@ void Game::input() {
 			if (event.key.keysym.sym == SDLK_ESCAPE) is_running = false;
 			if (event.key.keysym.sym == SDLK_F1) is_debugging = !is_debugging;
 
-			event_manager->emit<KeyPressedEvent>(event.key.keysym.sym);
+			// Live keys would make the replay diverge
+			if (!replayer) event_manager->emit<KeyPressedEvent>(event.key.keysym.sym);
+
+			break;
 
+		case SDL_RENDER_TARGETS_RESET:
+			// Render target contents are lost, the tilemap chunks have to be baked again
+			tilemap_renderer->invalidate();
 			break;
 		}
 	}
 
+	if (replayer) {
+		if (!replayer->next_frame(replay_frame)) {
+			is_running = false;
+			return;
+		}
+		for (SDL_Keycode key : replay_frame.keys) {
+			event_manager->emit<KeyPressedEvent>(key);
+		}
+	}
 }
 
 void Game::update() {
-	Uint32 time_to_wait = MILLISECONDS_PRE_FRAME - (SDL_GetTicks() - millisecs_prev_frame);
-	if (time_to_wait <= MILLISECONDS_PRE_FRAME) SDL_Delay(time_to_wait);
+	double delta_time{};
+	Uint32 ticks{};
+
+	// Replays use the recorded timing and run as fast as possible
+	if (replayer) {
+		delta_time = replay_frame.delta_time;
+		ticks = replay_frame.ticks;
+	}
+	// Headless frames are a fixed step apart so their images are reproducible
+	else if (is_headless) {
+		delta_time = 1.0 / FPS;
+		ticks = static_cast<Uint32>(static_cast<std::uint64_t>(frame) * 1000 / FPS);
+	}
+	else {
+		Uint32 time_to_wait = MILLISECONDS_PRE_FRAME - (SDL_GetTicks() - millisecs_prev_frame);
+		if (time_to_wait <= MILLISECONDS_PRE_FRAME) SDL_Delay(time_to_wait);
 
-	[[maybe_unused]] double delta_time = (SDL_GetTicks() - millisecs_prev_frame) / 1000.0;
+		// Millisecond ticks would make the step count jitter, the frame time comes from the performance counter
+		const Uint64 counter{ SDL_GetPerformanceCounter() };
+		delta_time = static_cast<double>(counter - counter_prev_frame) / static_cast<double>(SDL_GetPerformanceFrequency());
+		counter_prev_frame = counter;
 
-	millisecs_prev_frame = SDL_GetTicks();
+		millisecs_prev_frame = SDL_GetTicks();
+		ticks = millisecs_prev_frame;
+	}
 
-	event_manager->reset();
+	if (recorder) {
+		recorder->record_frame(delta_time, ticks);
+	}
 
-	registry->get_system<MovementSystem>().listen_to_event(*event_manager);
-	registry->get_system<DamageSystem>().listen_to_event(*event_manager);
-	registry->get_system<KeyboarControlSystem>().listen_to_event(*event_manager);
+	accumulator += std::min(delta_time, MAX_FRAME_TIME);
+
+	while (accumulator >= SIMULATION_STEP) {
+		accumulator -= SIMULATION_STEP;
 
-	registry->get_system<AnimationSystem>().update(delta_time);
-	registry->get_system<CollisionSystem>().update(*event_manager);
+		// Ticks at the end of this step, what is left in the accumulator is still ahead of it
+		simulate(SIMULATION_STEP, ticks - static_cast<Uint32>(accumulator * 1000.0));
+	}
+
+	interpolation_alpha = accumulator / SIMULATION_STEP;
+}
+
+void Game::simulate(double delta_time, Uint32 ticks) {
+	registry->get_system<InterpolationSystem>().update();
+	registry->get_system<AnimationSystem>().update(delta_time, *asset_manager, *event_manager);
+	registry->get_system<CollisionSystem>().update(*event_manager, *thread_pool, *tilemap);
+	registry->get_system<DamageSystem>().update(registry->get_system<CollisionSystem>().get_contacts(), *registry);
+	registry->get_system<MovementSystem>().on_contacts(registry->get_system<CollisionSystem>().get_contacts(), *registry);
+	event_manager->dispatch_all();
 	registry->get_system<MovementSystem>().update(delta_time);
-	registry->get_system<ScriptSystem>().update(delta_time, SDL_GetTicks());
-	registry->get_system<CameraMovementSystem>().update(&camera);
+	registry->get_system<ParticleSystem>().update(delta_time);
+	registry->get_system<ScriptSystem>().update(delta_time, ticks);
 	registry->get_system<ProjectileDurationSystem>().update(delta_time);
 	registry->get_system<ProjectileEmitSystem>().update(*registry, delta_time);
 
 	registry->update();
 }
 
-void Game::render() {
+void Game::record_snapshot(RenderSnapshot& snapshot) {
+	registry->get_system<CameraMovementSystem>().update(&camera, interpolation_alpha);
+
+	snapshot.clear();
+	snapshot.camera = camera;
+
+	registry->get_system<RenderSystem>().update(*asset_manager, snapshot, &camera, interpolation_alpha);
+	registry->get_system<ParticleSystem>().render(*asset_manager, snapshot, &camera, interpolation_alpha, SIMULATION_STEP);
+	registry->get_system<RenderHealthSystem>().update(*asset_manager, snapshot, &camera, interpolation_alpha);
+	registry->get_system<RenderTextSystem>().update(*asset_manager, snapshot, &camera);
+
+	if (is_debugging) {
+		registry->get_system<RenderCollisionSystem>().update(snapshot, interpolation_alpha);
+	}
+}
+
+void Game::render(const RenderSnapshot& snapshot) {
 	SDL_SetRenderDrawColor(renderer, 21, 21, 21, 255);
 	SDL_RenderClear(renderer);
 
-	registry->get_system<RenderSystem>().update(renderer, *asset_manager, &camera);
-	registry->get_system<RenderHealthSystem>().update(renderer, *asset_manager, &camera);
-	registry->get_system<RenderTextSystem>().update(renderer, *asset_manager, &camera);
+	tilemap_renderer->render(renderer, *asset_manager, *tilemap, *sprite_batch, snapshot.camera);
+	snapshot.submit(renderer, *sprite_batch);
+}
 
-	if (is_debugging) {
-		registry->get_system<RenderCollisionSystem>().update(renderer, &camera);
-		registry->get_system<RenderGuiSystem>().update(renderer, *registry, camera);
+void Game::present() {
+	// The GUI edits the registry, so it can't run while the simulation does
+	if (is_debugging && !is_headless) {
+		registry->get_system<RenderGuiSystem>().update(renderer, *registry, *asset_manager, camera);
 	}
 
 	SDL_RenderPresent(renderer);
+
+	++frame;
+
+	if (frame_capture) {
+		frame_capture->capture(headless_surface, frame);
+	}
 }
 
 void Game::destroy() {
-	ImGui_ImplSDLRenderer2_Shutdown();
-	ImGui_ImplSDL2_Shutdown();
-	ImGui::DestroyContext();
+	if (!is_headless) {
+		ImGui_ImplSDLRenderer2_Shutdown();
+		ImGui_ImplSDL2_Shutdown();
+		ImGui::DestroyContext();
+	}
 
+	// Chunk textures belong to the renderer
+	tilemap_renderer->clear();
 	SDL_DestroyRenderer(renderer);
-	SDL_DestroyWindow(window);
+	if (window) SDL_DestroyWindow(window);
+	SDL_FreeSurface(headless_surface);
 	//TTF_Quit();
 	SDL_Quit();
 }
 
+bool Game::golden_passed() const {
+	return !frame_capture || frame_capture->get_mismatched_frames() == 0;
+}
@@ -4,11 +4,21 @@
 #include "../asset_manager/asset_manager.hpp"
 #include "../ecs/ecs.hpp"
 #include "../event_manager/event_manager.hpp"
+#include "../event_manager/event_recorder.hpp"
+#include "../renderer/frame_capture.hpp"
+#include "../renderer/render_snapshot.hpp"
+#include "../renderer/sprite_batch.hpp"
+#include "../renderer/tilemap_renderer.hpp"
+#include "../thread_pool/thread_pool.hpp"
+#include "../thread_pool/worker_thread.hpp"
+#include "../tilemap/tilemap.hpp"
 
 #include <SDL2/SDL.h>
 #include <sol/sol.hpp>
 
+#include <array>
 #include <memory>
+#include <string>
 
 struct SDL_Window;
 struct SDL_Renderer;
@@ -16,6 +26,25 @@ struct SDL_Renderer;
 constexpr int FPS{ 60 };
 constexpr int MILLISECONDS_PRE_FRAME{ 1000 / FPS };
 
+// The simulation advances in fixed steps, rendering interpolates between the last two
+constexpr int SIMULATION_RATE{ 30 };
+constexpr double SIMULATION_STEP{ 1.0 / SIMULATION_RATE };
+// Longest frame time simulated at once, past it the game slows down instead of catching up
+constexpr double MAX_FRAME_TIME{ 0.25 };
+
+struct GameConfig {
+	int level{ 1 };
+	std::string record_path{}; // records the session inputs when set
+	std::string replay_path{}; // replays a recorded session (and its level) when set
+
+	// Renders into an offscreen software surface, without window, vsync or debug GUI,
+	// advancing every frame by exactly 1 / FPS.
+	bool headless{};
+	int frames{};             // stops after this many frames when > 0
+	std::string dump_dir{};   // saves every rendered frame as a PNG when set
+	std::string golden_dir{}; // compares every rendered frame with the PNGs in it when set
+};
+
 class Game {
 public:
 	static int window_width;
@@ -27,27 +56,60 @@ public:
 	~Game();
 	Game(const Game&) = delete;
 	Game operator=(const Game&) = delete;
-	void init();
-	void run(int level);
+	void init(const GameConfig& config);
+	void run(const GameConfig& config);
 	void setup(int level);
 	void input();
 	void update();
-	void render();
+	void simulate(double delta_time, Uint32 ticks);
+	// Records what the current state of the game draws, runs on the simulation thread.
+	void record_snapshot(RenderSnapshot& snapshot);
+	void render(const RenderSnapshot& snapshot);
+	// Debug GUI and present, once the simulation thread is idle.
+	void present();
 	void destroy();
 
+	// False if any frame differed from its golden image.
+	bool golden_passed() const;
+
 private:
 	bool is_running{};
 	bool is_debugging{};
 	Uint32 millisecs_prev_frame{ 0 };
+	Uint64 counter_prev_frame{ 0 };
 	SDL_Window* window{ nullptr };
 	SDL_Renderer* renderer{ nullptr };
+	SDL_Surface* headless_surface{ nullptr };
+	bool is_headless{};
+	Uint32 frame{ 0 };
+	double accumulator{};
+	double interpolation_alpha{};
 	SDL_Rect camera{};
 
 	sol::state lua{};
 
+	// Declared before the registry so it outlives the subscriptions held by systems
+	std::unique_ptr<EventManager> event_manager{ nullptr };
 	std::unique_ptr<Registry> registry{ nullptr };
 	std::unique_ptr<AssetManager> asset_manager{ nullptr };
-	std::unique_ptr<EventManager> event_manager{ nullptr };
+	std::unique_ptr<ThreadPool> thread_pool{ nullptr };
+	std::unique_ptr<Tilemap> tilemap{ nullptr };
+	std::unique_ptr<SpriteBatch> sprite_batch{ nullptr };
+	std::unique_ptr<TilemapRenderer> tilemap_renderer{ nullptr };
+	std::unique_ptr<FrameCapture> frame_capture{ nullptr };
+	std::unique_ptr<EventRecorder> recorder{ nullptr };
+	std::unique_ptr<EventReplayer> replayer{ nullptr };
+	ReplayFrame replay_frame{};
+
+	// The simulation records into one snapshot while the other one is drawn
+	std::array<RenderSnapshot, 2> snapshots{};
+	std::size_t front_snapshot{};
+
+	// Declared last so it is joined before anything its jobs use is destroyed
+	std::unique_ptr<WorkerThread> simulation_thread{ nullptr };
+
+	bool init_window_renderer();
+	bool init_headless_renderer();
 };
 
 #endif //GAME_HPP
@@ -5,6 +5,7 @@
 #include "../components/camera_component.hpp"
 #include "../components/health_component.hpp"
 #include "../components/keyboard_control_component.hpp"
+#include "../components/particle_emitter_component.hpp"
 #include "../components/projectile_component.hpp"
 #include "../components/projectile_emitter_component.hpp"
 #include "../components/rigidbody_component.hpp"
@@ -15,11 +16,15 @@
 
 #include <sol/sol.hpp>
 
-#include <fstream>
 
 static std::string get_exe_dir();
 static std::string exe_dir{ get_exe_dir() };
 
+static double frame_duration(double seconds);
+static AnimationClip load_animation_clip(const sol::table& asset);
+static AnimationClipHandle add_strip_clip(AssetManager* asset_manager, int y, int width, int height, int frames, double frame_delay, bool loop);
+static AnimationClipHandle find_clip(AssetManager* asset_manager, const sol::optional<std::string>& clip_id);
+
 LevelLoader::LevelLoader() {
 
 }
@@ -28,7 +33,7 @@ LevelLoader::~LevelLoader() {
 
 }
 
-void LevelLoader::load_level(sol::state& lua, SDL_Renderer* renderer, Registry* registry, AssetManager* asset_manager, int level_num) {
+void LevelLoader::load_level(sol::state& lua, SDL_Renderer* renderer, Registry* registry, AssetManager* asset_manager, Tilemap* tilemap, int level_num) {
 
 	(void)renderer; (void)registry; (void)asset_manager;
 
@@ -69,7 +74,7 @@ void LevelLoader::load_level(sol::state& lua, SDL_Renderer* renderer, Registry*
 		std::string asset_id{ asset["id"] };
 
 		if (asset_type == "texture") {
-			asset_manager->add_texture(renderer, asset_id, asset["file"]);
+			asset_manager->add_texture(asset_id, asset["file"]);
 
 			Logger::log("New texture loaded to asset manager id: " + asset_id);
 		}
@@ -78,9 +83,18 @@ void LevelLoader::load_level(sol::state& lua, SDL_Renderer* renderer, Registry*
 
 			Logger::log("New font loaded to asset manager id: " + asset_id);
 		}
+		else if (asset_type == "animation") {
+			asset_manager->add_animation_clip(asset_id, load_animation_clip(asset));
+
+			Logger::log("New animation clip loaded to asset manager id: " + asset_id);
+		}
 		++i;
 	}
 
+	//Pack the level textures into atlases, cached next to the executable for the next startups
+	asset_manager->build_atlases(renderer, exe_dir + "/atlas_cache/level" + std::to_string(level_num));
+	asset_manager->build_glyph_atlases(renderer);
+
 	//Reading map
 	sol::table map{ level["tilemap"] };
 	std::string map_path{ map["map_file"] };
@@ -92,43 +106,18 @@ void LevelLoader::load_level(sol::state& lua, SDL_Renderer* renderer, Registry*
 
 	double map_scale{ map["scale"] };
 
-	std::fstream map_file{};
-	map_file.open(map_path);
-
-	for (int y{}; y < map_rows_count; ++y) {
-		for (int x{}; x < map_cols_count; ++x) {
-			char ch;
-			map_file.get(ch);
-			int src_rect_y{ std::atoi(&ch) * tile_size };
-			map_file.get(ch);
-			int src_rect_x{ std::atoi(&ch) * tile_size };
-			map_file.ignore();
-
-			Entity tile{ registry->create_entity() };
-			tile.add_component<TransformComponent>(
-				glm::dvec2(
-					x * (map_scale * tile_size),
-					y * (map_scale * tile_size)
-				),
-				glm::dvec2(
-					map_scale,
-					map_scale
-				),
-				0.0
-			);
-			tile.add_component<SpriteComponent>(
-				map_texture_asset_id,
-				0,
-				false,
-				tile_size,
-				tile_size,
-				src_rect_x,
-				src_rect_y
-			);
-		}
+	tilemap->reset(map_rows_count, map_cols_count, tile_size, map_scale);
+
+	//Optional solidity bitmap, same layout as the map file
+	sol::optional<std::string> solidity_path{ map["solidity_file"] };
+	if (solidity_path != sol::nullopt) {
+		tilemap->load_solidity(*solidity_path);
 	}
 
-	map_file.close();
+	//Tiles are drawn by the tilemap renderer in chunks, not as entities
+	asset_manager->add_map("tilemap", map_path);
+	asset_manager->load_map(*tilemap, "tilemap", asset_manager->get_texture_handle(map_texture_asset_id));
+
 	Game::map_width = static_cast<int>(map_cols_count * tile_size * map_scale);
 	Game::map_height = static_cast<int>(map_rows_count * tile_size * map_scale);
 
@@ -189,8 +178,15 @@ void LevelLoader::load_level(sol::state& lua, SDL_Renderer* renderer, Registry*
 
 			sol::optional<sol::table> sprite{ entity["components"]["sprite"] };
 			if (sprite != sol::nullopt) {
+				std::string texture_asset_id{ entity["components"]["sprite"]["texture_asset_id"] };
+				TextureHandle texture{ asset_manager->get_texture_handle(texture_asset_id) };
+
+				if (!texture.is_valid()) {
+					Logger::err("Sprite texture not found in asset manager id: " + texture_asset_id);
+				}
+
 				e.add_component<SpriteComponent>(
-					entity["components"]["sprite"]["texture_asset_id"],
+					texture,
 					entity["components"]["sprite"]["z_index"].get_or(1),
 					entity["components"]["sprite"]["fixed"].get_or(false),
 					entity["components"]["sprite"]["width"],
@@ -202,10 +198,27 @@ void LevelLoader::load_level(sol::state& lua, SDL_Renderer* renderer, Registry*
 
 			sol::optional<sol::table> animation{ entity["components"]["animation"] };
 			if (animation != sol::nullopt) {
-				e.add_component<AnimationComponent>(
-					entity["components"]["animation"]["num_frames"],
-					entity["components"]["animation"]["frame_delay"]
-				);
+				sol::optional<std::string> clip_id{ entity["components"]["animation"]["clip"] };
+				AnimationClipHandle clip{};
+
+				if (clip_id != sol::nullopt) {
+					clip = find_clip(asset_manager, clip_id);
+				}
+				else if (e.has_component<SpriteComponent>()) {
+					//Inline frame settings, entities with the same ones share a strip clip
+					const SpriteComponent& sprite_component{ e.get_component<SpriteComponent>() };
+					clip = add_strip_clip(
+						asset_manager,
+						sprite_component.src_rect.y,
+						sprite_component.width,
+						sprite_component.height,
+						entity["components"]["animation"]["num_frames"].get_or(1),
+						entity["components"]["animation"]["frame_delay"].get_or(0.0),
+						entity["components"]["animation"]["loop"].get_or(true)
+					);
+				}
+
+				e.add_component<AnimationComponent>(clip);
 			}
 
 			sol::optional<sol::table> collider{ entity["components"]["boxcollider"] };
@@ -216,7 +229,8 @@ void LevelLoader::load_level(sol::state& lua, SDL_Renderer* renderer, Registry*
 					glm::dvec2(
 						entity["components"]["boxcollider"]["offset"]["x"].get_or(0.0),
 						entity["components"]["boxcollider"]["offset"]["y"].get_or(0.0)
-					)
+					),
+					entity["components"]["boxcollider"]["continuous"].get_or(false)
 				);
 			}
 
@@ -237,7 +251,43 @@ void LevelLoader::load_level(sol::state& lua, SDL_Renderer* renderer, Registry*
 					static_cast<int>(entity["components"]["projectile_emitter"]["hit_percentage_damage"].get_or(10)),
 					static_cast<double>(entity["components"]["projectile_emitter"]["emission_delay"].get_or(2.0)),
 					static_cast<double>(entity["components"]["projectile_emitter"]["projectile_duration"].get_or(10)),
-					entity["components"]["projectile_emitter"]["friendly"].get_or(false)
+					entity["components"]["projectile_emitter"]["friendly"].get_or(false),
+					asset_manager->get_texture_handle(
+						entity["components"]["projectile_emitter"]["projectile_texture_asset_id"].get_or(std::string{ "bullet-texture" })
+					)
+				);
+			}
+
+			sol::optional<sol::table> particle_emitter{ entity["components"]["particle_emitter"] };
+			if (particle_emitter != sol::nullopt) {
+				std::string texture_asset_id{ entity["components"]["particle_emitter"]["texture_asset_id"] };
+				TextureHandle texture{ asset_manager->get_texture_handle(texture_asset_id) };
+
+				if (!texture.is_valid()) {
+					Logger::err("Particle texture not found in asset manager id: " + texture_asset_id);
+				}
+
+				e.add_component<ParticleEmitterComponent>(
+					texture,
+					entity["components"]["particle_emitter"]["frame_width"].get_or(8),
+					entity["components"]["particle_emitter"]["frame_height"].get_or(8),
+					entity["components"]["particle_emitter"]["frames"].get_or(1),
+					entity["components"]["particle_emitter"]["frame_rate"].get_or(10.0),
+					entity["components"]["particle_emitter"]["scale"].get_or(1.0),
+					entity["components"]["particle_emitter"]["rate"].get_or(10.0),
+					entity["components"]["particle_emitter"]["burst"].get_or(0),
+					entity["components"]["particle_emitter"]["lifetime"].get_or(1.0),
+					entity["components"]["particle_emitter"]["lifetime_jitter"].get_or(0.0),
+					glm::dvec2(
+						entity["components"]["particle_emitter"]["velocity"]["x"].get_or(0.0),
+						entity["components"]["particle_emitter"]["velocity"]["y"].get_or(0.0)
+					),
+					entity["components"]["particle_emitter"]["spread"].get_or(0.0),
+					glm::dvec2(
+						entity["components"]["particle_emitter"]["offset"]["x"].get_or(0.0),
+						entity["components"]["particle_emitter"]["offset"]["y"].get_or(0.0)
+					),
+					entity["components"]["particle_emitter"]["duration"].get_or(-1.0)
 				);
 			}
 
@@ -248,6 +298,35 @@ void LevelLoader::load_level(sol::state& lua, SDL_Renderer* renderer, Registry*
 
 			sol::optional<sol::table> keyboard_controlled{ entity["components"]["keyboard_controller"] };
 			if (keyboard_controlled != sol::nullopt) {
+				//Facing clips: named ones, or the sprite rows (up, right, down, left) with the inline animation settings
+				AnimationClipHandle direction_clips[4]{};
+				const char* direction_clip_keys[4]{ "up_clip", "right_clip", "down_clip", "left_clip" };
+
+				for (int d{}; d < 4; ++d) {
+					sol::optional<std::string> clip_id{ entity["components"]["keyboard_controller"][direction_clip_keys[d]] };
+
+					if (clip_id != sol::nullopt) {
+						direction_clips[d] = find_clip(asset_manager, clip_id);
+					}
+					else if (animation != sol::nullopt && e.has_component<SpriteComponent>()) {
+						sol::optional<int> num_frames{ entity["components"]["animation"]["num_frames"] };
+						if (num_frames == sol::nullopt) {
+							continue;
+						}
+
+						const SpriteComponent& sprite_component{ e.get_component<SpriteComponent>() };
+						direction_clips[d] = add_strip_clip(
+							asset_manager,
+							d * sprite_component.height,
+							sprite_component.width,
+							sprite_component.height,
+							*num_frames,
+							entity["components"]["animation"]["frame_delay"].get_or(0.0),
+							entity["components"]["animation"]["loop"].get_or(true)
+						);
+					}
+				}
+
 				e.add_component<KeyboardControlComponent>(
 
 					glm::dvec2(
@@ -265,7 +344,11 @@ void LevelLoader::load_level(sol::state& lua, SDL_Renderer* renderer, Registry*
 					glm::dvec2(
 						entity["components"]["keyboard_controller"]["left_velocity"]["x"],
 						entity["components"]["keyboard_controller"]["left_velocity"]["y"]
-					)
+					),
+					direction_clips[0],
+					direction_clips[1],
+					direction_clips[2],
+					direction_clips[3]
 				);
 			}
 
@@ -283,6 +366,94 @@ void LevelLoader::load_level(sol::state& lua, SDL_Renderer* renderer, Registry*
 	}
 }
 
+// Level tables are indexed from 0, plain Lua lists from 1
+static int first_index(const sol::table& table) {
+	sol::optional<sol::table> first{ table[0] };
+	return first != sol::nullopt ? 0 : 1;
+}
+
+// Frames without a positive delay last one simulation step, the old AnimationSystem
+// advanced them once per update.
+static double frame_duration(double seconds) {
+	return seconds > 0.0 ? seconds : SIMULATION_STEP;
+}
+
+// Either a 'frames' list of { x, y, w, h, duration } or a strip of 'num_frames' frames from (x, y).
+static AnimationClip load_animation_clip(const sol::table& asset) {
+	const double frame_delay{ frame_duration(asset["frame_delay"].get_or(0.1)) };
+	const int frame_width{ asset["frame_width"].get_or(sprite_config::width) };
+	const int frame_height{ asset["frame_height"].get_or(sprite_config::height) };
+
+	AnimationClip clip{};
+
+	sol::optional<sol::table> frames{ asset["frames"] };
+	if (frames != sol::nullopt) {
+		for (int i{ first_index(*frames) };; ++i) {
+			sol::optional<sol::table> frame{ (*frames)[i] };
+			if (frame == sol::nullopt) {
+				break;
+			}
+
+			clip.add_frame(
+				{
+					(*frame)["x"].get_or(0),
+					(*frame)["y"].get_or(0),
+					(*frame)["w"].get_or(frame_width),
+					(*frame)["h"].get_or(frame_height)
+				},
+				frame_duration((*frame)["duration"].get_or(frame_delay))
+			);
+		}
+	}
+	else {
+		clip = AnimationClip::strip(
+			asset["x"].get_or(0),
+			asset["y"].get_or(0),
+			frame_width,
+			frame_height,
+			asset["num_frames"].get_or(1),
+			frame_delay
+		);
+	}
+
+	clip.loop = asset["loop"].get_or(true);
+
+	sol::optional<sol::table> events{ asset["events"] };
+	if (events != sol::nullopt) {
+		for (int i{ first_index(*events) };; ++i) {
+			sol::optional<sol::table> event{ (*events)[i] };
+			if (event == sol::nullopt) {
+				break;
+			}
+
+			clip.add_event((*event)["time"].get_or(0.0), (*event)["name"].get_or(std::string{}));
+		}
+	}
+
+	return clip;
+}
+
+static AnimationClipHandle add_strip_clip(AssetManager* asset_manager, int y, int width, int height, int frames, double frame_delay, bool loop) {
+	frame_delay = frame_duration(frame_delay);
+
+	const std::string asset_id{
+		"strip:" + std::to_string(y) + ":" + std::to_string(width) + "x" + std::to_string(height) + ":" +
+		std::to_string(frames) + ":" + std::to_string(frame_delay) + (loop ? ":loop" : "")
+	};
+
+	return asset_manager->add_animation_clip(asset_id, AnimationClip::strip(0, y, width, height, frames, frame_delay, loop));
+}
+
+static AnimationClipHandle find_clip(AssetManager* asset_manager, const sol::optional<std::string>& clip_id) {
+	AnimationClipHandle clip{ asset_manager->get_animation_clip_handle(*clip_id) };
+
+	if (!clip.is_valid()) {
+		Logger::err("Animation clip not found in asset manager id: " + *clip_id);
+	}
+
+	return clip;
+}
+
 #include <libgen.h>
 #include <unistd.h>
 #include <linux/limits.h> 
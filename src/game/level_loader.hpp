@@ -5,6 +5,7 @@
 
 #include "../asset_manager/asset_manager.hpp"
 #include "../ecs/ecs.hpp"
+#include "../tilemap/tilemap.hpp"
 
 #include <SDL2/SDL.h>
 #include <sol/sol.hpp>
@@ -14,7 +15,7 @@ public:
 	LevelLoader();
 	~LevelLoader();
 
-	void load_level(sol::state& lua, SDL_Renderer* renderer, Registry* registry, AssetManager* asset_manager, int level_num);
+	void load_level(sol::state& lua, SDL_Renderer* renderer, Registry* registry, AssetManager* asset_manager, Tilemap* tilemap, int level_num);
 };
 
 #endif //LEVEL_LOADER_HPP
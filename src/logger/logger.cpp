@@ -3,6 +3,7 @@
 #include <chrono>
 #include <ctime>
 #include <iostream>
+#include <mutex>
 
 #define GREEN "\033[32m"
 #define RED "\033[31m"
@@ -10,9 +11,14 @@
 
 std::vector <LogEntry> Logger::logs{};
 
+// The simulation and render threads both log
+static std::mutex log_mutex{};
+
 static void append_current_date_time(std::string& dt_str);
 
 void Logger::log(const std::string& message) {
+	std::lock_guard lock{ log_mutex };
+
 	std::string output{ "LOG: [" };
 	append_current_date_time(output);
 	output.append("] - ").append(message);
@@ -25,6 +31,8 @@ void Logger::log(const std::string& message) {
 }
 
 void Logger::err(const std::string& message) {
+	std::lock_guard lock{ log_mutex };
+
 	std::string output{ "ERR: [" };
 	append_current_date_time(output);
 	output.append("] - ").append(message);
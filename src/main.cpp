@@ -1,22 +1,74 @@
 #include "game/game.hpp"
+#include "logger/logger.hpp"
 
+#include <charconv>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <system_error>
+
+// The whole argument as an int, 'value' is left as is for anything else.
+static bool parse_int(const char* arg, int& value) {
+	const char* last{ arg + std::strlen(arg) };
+	int parsed{};
+	const std::from_chars_result result{ std::from_chars(arg, last, parsed) };
+
+	if (arg == last || result.ec != std::errc{} || result.ptr != last) {
+		return false;
+	}
+
+	value = parsed;
+	return true;
+}
 
 int main(int argc, char* argv[]) {
 
-	int level{ 1 };
+	GameConfig config{};
 
-	if (argc == 2) {
-		level = std::stoi(argv[1]);
-		level = (level < 1 || level > 2) ? 1 : level;
+	for (int i{ 1 }; i < argc; ++i) {
+		std::string arg{ argv[i] };
+
+		if (arg == "--record" && i + 1 < argc) {
+			config.record_path = argv[++i];
+		}
+		else if (arg == "--replay" && i + 1 < argc) {
+			config.replay_path = argv[++i];
+		}
+		else if (arg == "--headless") {
+			config.headless = true;
+		}
+		else if (arg == "--frames" && i + 1 < argc) {
+			if (!parse_int(argv[++i], config.frames)) {
+				Logger::err("Unknown or incomplete argument: " + arg + " " + argv[i]);
+			}
+		}
+		else if (arg == "--dump-dir" && i + 1 < argc) {
+			config.dump_dir = argv[++i];
+		}
+		else if (arg == "--golden-dir" && i + 1 < argc) {
+			config.golden_dir = argv[++i];
+		}
+		else if (arg.starts_with("--")) {
+			Logger::err("Unknown or incomplete argument: " + arg);
+		}
+		else {
+			if (!parse_int(argv[i], config.level) || config.level < 1 || config.level > 2) {
+				config.level = 1;
+			}
+		}
+	}
+
+	// Nothing would ever end a headless run otherwise
+	if (config.headless && config.frames <= 0 && config.replay_path.empty()) {
+		config.frames = 600;
+		Logger::log("Headless run without --frames, stopping after 600 frames");
 	}
 
 	Game game{};
 
-	game.init();
-	game.run(level);
+	game.init(config);
+	game.run(config);
 	game.destroy();
 
-	return 0;
+	return game.golden_passed() ? 0 : 1;
 }
-
@@ -0,0 +1,69 @@
+#ifndef PARTICLE_BUFFER_HPP
+#define PARTICLE_BUFFER_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/*
+* Live particles stored as SoA arrays outside of the ECS, so the update kernel can stream them.
+* 'age' drives the animation frame, 'style' indexes the look (texture, frames, size) of the particle.
+*/
+struct ParticleBuffer {
+	std::vector<float> x{};
+	std::vector<float> y{};
+	std::vector<float> velocity_x{};
+	std::vector<float> velocity_y{};
+	std::vector<float> life{};
+	std::vector<float> age{};
+	std::vector<std::uint16_t> style{};
+
+	std::size_t size() const { return x.size(); }
+
+	void clear() {
+		resize(0);
+	}
+
+	void reserve(std::size_t size) {
+		x.reserve(size);
+		y.reserve(size);
+		velocity_x.reserve(size);
+		velocity_y.reserve(size);
+		life.reserve(size);
+		age.reserve(size);
+		style.reserve(size);
+	}
+
+	void resize(std::size_t size) {
+		x.resize(size);
+		y.resize(size);
+		velocity_x.resize(size);
+		velocity_y.resize(size);
+		life.resize(size);
+		age.resize(size);
+		style.resize(size);
+	}
+
+	void push_back(float px, float py, float vx, float vy, float lifetime, std::uint16_t particle_style) {
+		x.push_back(px);
+		y.push_back(py);
+		velocity_x.push_back(vx);
+		velocity_y.push_back(vy);
+		life.push_back(lifetime);
+		age.push_back(0.0f);
+		style.push_back(particle_style);
+	}
+
+	// Copies particle 'from' over particle 'to'.
+	void move(std::size_t from, std::size_t to) {
+		x[to] = x[from];
+		y[to] = y[from];
+		velocity_x[to] = velocity_x[from];
+		velocity_y[to] = velocity_y[from];
+		life[to] = life[from];
+		age[to] = age[from];
+		style[to] = style[from];
+	}
+};
+
+#endif //PARTICLE_BUFFER_HPP
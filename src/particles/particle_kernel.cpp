@@ -0,0 +1,131 @@
+#include "particle_kernel.hpp"
+
+#if !defined(ENGINE_SIMD_SCALAR) && defined(__AVX2__)
+#define PARTICLE_KERNEL_AVX2
+#include <immintrin.h>
+#elif !defined(ENGINE_SIMD_SCALAR) && defined(__SSE2__)
+#define PARTICLE_KERNEL_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+	void integrate_scalar(ParticleBuffer& particles, float delta_time, std::size_t first) {
+		const std::size_t count{ particles.size() };
+
+		for (std::size_t i{ first }; i < count; ++i) {
+			particles.x[i] += particles.velocity_x[i] * delta_time;
+			particles.y[i] += particles.velocity_y[i] * delta_time;
+			particles.life[i] -= delta_time;
+			particles.age[i] += delta_time;
+		}
+	}
+
+	// Removes the particles with no life left from 'first' on, the survivors keep their order.
+	void compact(ParticleBuffer& particles, std::size_t first) {
+		const std::size_t count{ particles.size() };
+		std::size_t alive{ first };
+
+		for (std::size_t i{ first }; i < count; ++i) {
+			if (particles.life[i] > 0.0f) {
+				if (alive != i) {
+					particles.move(i, alive);
+				}
+				++alive;
+			}
+		}
+
+		if (alive != count) {
+			particles.resize(alive);
+		}
+	}
+}
+
+const char* particle_kernel::name() {
+#if defined(PARTICLE_KERNEL_AVX2)
+	return "avx2";
+#elif defined(PARTICLE_KERNEL_SSE2)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+void particle_kernel::update_scalar(ParticleBuffer& particles, float delta_time) {
+	integrate_scalar(particles, delta_time, 0);
+	compact(particles, 0);
+}
+
+#if defined(PARTICLE_KERNEL_AVX2)
+
+void particle_kernel::update(ParticleBuffer& particles, float delta_time) {
+	const std::size_t count{ particles.size() };
+	const std::size_t simd_count{ count - count % 8 };
+
+	const __m256 dt{ _mm256_set1_ps(delta_time) };
+	const __m256 zero{ _mm256_setzero_ps() };
+
+	// Index of the first block holding an expired particle, nothing to move before it
+	std::size_t first_dead{ count };
+
+	for (std::size_t i{}; i < simd_count; i += 8) {
+		const __m256 x{ _mm256_add_ps(_mm256_loadu_ps(&particles.x[i]), _mm256_mul_ps(_mm256_loadu_ps(&particles.velocity_x[i]), dt)) };
+		const __m256 y{ _mm256_add_ps(_mm256_loadu_ps(&particles.y[i]), _mm256_mul_ps(_mm256_loadu_ps(&particles.velocity_y[i]), dt)) };
+		const __m256 life{ _mm256_sub_ps(_mm256_loadu_ps(&particles.life[i]), dt) };
+		const __m256 age{ _mm256_add_ps(_mm256_loadu_ps(&particles.age[i]), dt) };
+
+		_mm256_storeu_ps(&particles.x[i], x);
+		_mm256_storeu_ps(&particles.y[i], y);
+		_mm256_storeu_ps(&particles.life[i], life);
+		_mm256_storeu_ps(&particles.age[i], age);
+
+		if (first_dead == count && _mm256_movemask_ps(_mm256_cmp_ps(life, zero, _CMP_LE_OQ)) != 0) {
+			first_dead = i;
+		}
+	}
+
+	integrate_scalar(particles, delta_time, simd_count);
+
+	compact(particles, first_dead < simd_count ? first_dead : simd_count);
+}
+
+#elif defined(PARTICLE_KERNEL_SSE2)
+
+void particle_kernel::update(ParticleBuffer& particles, float delta_time) {
+	const std::size_t count{ particles.size() };
+	const std::size_t simd_count{ count - count % 4 };
+
+	const __m128 dt{ _mm_set1_ps(delta_time) };
+	const __m128 zero{ _mm_setzero_ps() };
+
+	// Index of the first block holding an expired particle, nothing to move before it
+	std::size_t first_dead{ count };
+
+	for (std::size_t i{}; i < simd_count; i += 4) {
+		const __m128 x{ _mm_add_ps(_mm_loadu_ps(&particles.x[i]), _mm_mul_ps(_mm_loadu_ps(&particles.velocity_x[i]), dt)) };
+		const __m128 y{ _mm_add_ps(_mm_loadu_ps(&particles.y[i]), _mm_mul_ps(_mm_loadu_ps(&particles.velocity_y[i]), dt)) };
+		const __m128 life{ _mm_sub_ps(_mm_loadu_ps(&particles.life[i]), dt) };
+		const __m128 age{ _mm_add_ps(_mm_loadu_ps(&particles.age[i]), dt) };
+
+		_mm_storeu_ps(&particles.x[i], x);
+		_mm_storeu_ps(&particles.y[i], y);
+		_mm_storeu_ps(&particles.life[i], life);
+		_mm_storeu_ps(&particles.age[i], age);
+
+		if (first_dead == count && _mm_movemask_ps(_mm_cmple_ps(life, zero)) != 0) {
+			first_dead = i;
+		}
+	}
+
+	integrate_scalar(particles, delta_time, simd_count);
+
+	compact(particles, first_dead < simd_count ? first_dead : simd_count);
+}
+
+#else
+
+void particle_kernel::update(ParticleBuffer& particles, float delta_time) {
+	update_scalar(particles, delta_time);
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef PARTICLE_KERNEL_HPP
+#define PARTICLE_KERNEL_HPP
+
+#include "particle_buffer.hpp"
+
+/*
+* Batched particle update over a ParticleBuffer: integrates positions, ages the particles
+* and compacts the expired ones away, keeping the order of the others.
+* The implementation is picked at build time (see ENGINE_SIMD in CMakeLists.txt):
+* AVX2 processes 8 particles per iteration, SSE2 processes 4, the scalar path 1.
+*/
+namespace particle_kernel {
+
+	// Name of the kernel compiled into this build ("avx2", "sse2" or "scalar").
+	const char* name();
+
+	void update(ParticleBuffer& particles, float delta_time);
+
+	// Reference implementation, always available regardless of the build flags.
+	void update_scalar(ParticleBuffer& particles, float delta_time);
+}
+
+#endif //PARTICLE_KERNEL_HPP
@@ -0,0 +1,120 @@
+#include "debug_draw.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void DebugDraw::begin(const SDL_Rect& camera) {
+	this->camera = camera;
+
+	for (Batch& batch : batches) {
+		batch.fill_rects.clear();
+		batch.rects.clear();
+		batch.line_vertices.clear();
+		batch.line_indices.clear();
+	}
+}
+
+bool DebugDraw::is_visible(int x1, int y1, int x2, int y2) const {
+	return x2 >= camera.x && x1 <= camera.x + camera.w && y2 >= camera.y && y1 <= camera.y + camera.h;
+}
+
+DebugDraw::Batch& DebugDraw::get_batch(SDL_Color color) {
+	auto same_color = [&color](const Batch& batch) {
+		return batch.color.r == color.r && batch.color.g == color.g && batch.color.b == color.b && batch.color.a == color.a;
+	};
+
+	// Shapes mostly come in runs of the same color
+	if (last_batch < batches.size() && same_color(batches[last_batch])) {
+		return batches[last_batch];
+	}
+
+	auto it{ std::find_if(batches.begin(), batches.end(), same_color) };
+	if (it == batches.end()) {
+		batches.push_back({ color });
+		it = batches.end() - 1;
+	}
+
+	last_batch = static_cast<std::size_t>(it - batches.begin());
+	return *it;
+}
+
+void DebugDraw::line(int x1, int y1, int x2, int y2, SDL_Color color) {
+	if (!is_visible(std::min(x1, x2), std::min(y1, y2), std::max(x1, x2), std::max(y1, y2))) {
+		return;
+	}
+
+	// Through the pixel centers and half a pixel past both ends, covering the pixels SDL_RenderDrawLine would
+	const float ax{ static_cast<float>(x1 - camera.x) + 0.5f };
+	const float ay{ static_cast<float>(y1 - camera.y) + 0.5f };
+	const float bx{ static_cast<float>(x2 - camera.x) + 0.5f };
+	const float by{ static_cast<float>(y2 - camera.y) + 0.5f };
+
+	const float length{ std::hypot(bx - ax, by - ay) };
+	const float ux{ length > 0.0f ? (bx - ax) / length * 0.5f : 0.5f };
+	const float uy{ length > 0.0f ? (by - ay) / length * 0.5f : 0.0f };
+
+	Batch& batch{ get_batch(color) };
+	const int first{ static_cast<int>(batch.line_vertices.size()) };
+
+	batch.line_vertices.push_back({ { ax - ux + uy, ay - uy - ux }, color, {} });
+	batch.line_vertices.push_back({ { ax - ux - uy, ay - uy + ux }, color, {} });
+	batch.line_vertices.push_back({ { bx + ux - uy, by + uy + ux }, color, {} });
+	batch.line_vertices.push_back({ { bx + ux + uy, by + uy - ux }, color, {} });
+
+	for (int index : { 0, 1, 2, 0, 2, 3 }) {
+		batch.line_indices.push_back(first + index);
+	}
+}
+
+void DebugDraw::rect(const SDL_Rect& rect, SDL_Color color) {
+	if (!is_visible(rect.x, rect.y, rect.x + rect.w, rect.y + rect.h)) {
+		return;
+	}
+
+	get_batch(color).rects.push_back({ rect.x - camera.x, rect.y - camera.y, rect.w, rect.h });
+}
+
+void DebugDraw::fill_rect(const SDL_Rect& rect, SDL_Color color) {
+	if (!is_visible(rect.x, rect.y, rect.x + rect.w, rect.y + rect.h)) {
+		return;
+	}
+
+	get_batch(color).fill_rects.push_back({ rect.x - camera.x, rect.y - camera.y, rect.w, rect.h });
+}
+
+void DebugDraw::flush(SDL_Renderer* renderer) const {
+	// Filled shapes first so outlines stay visible on top of them
+	for (const Batch& batch : batches) {
+		if (batch.fill_rects.empty()) {
+			continue;
+		}
+
+		SDL_SetRenderDrawColor(renderer, batch.color.r, batch.color.g, batch.color.b, batch.color.a);
+		SDL_RenderFillRects(renderer, batch.fill_rects.data(), static_cast<int>(batch.fill_rects.size()));
+	}
+
+	for (const Batch& batch : batches) {
+		if (!batch.rects.empty()) {
+			SDL_SetRenderDrawColor(renderer, batch.color.r, batch.color.g, batch.color.b, batch.color.a);
+			SDL_RenderDrawRects(renderer, batch.rects.data(), static_cast<int>(batch.rects.size()));
+		}
+
+		// The color is carried by the vertices
+		if (!batch.line_vertices.empty()) {
+			SDL_RenderGeometry(
+				renderer,
+				nullptr,
+				batch.line_vertices.data(),
+				static_cast<int>(batch.line_vertices.size()),
+				batch.line_indices.data(),
+				static_cast<int>(batch.line_indices.size())
+			);
+		}
+	}
+}
+
+bool DebugDraw::empty() const {
+	return std::all_of(batches.begin(), batches.end(), [](const Batch& batch) {
+		return batch.fill_rects.empty() && batch.rects.empty() && batch.line_vertices.empty();
+	});
+}
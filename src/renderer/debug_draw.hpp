@@ -0,0 +1,48 @@
+#ifndef DEBUG_DRAW_HPP
+#define DEBUG_DRAW_HPP
+
+#include <SDL2/SDL.h>
+
+#include <cstddef>
+#include <vector>
+
+/*
+* Immediate-mode collector for untextured shapes (lines, outlined and filled rects) given in world space.
+* Shapes outside the camera are dropped, the others are moved to screen space and grouped by color,
+* so flushing sets the draw color once per color and draws each group with one SDL_RenderFillRects /
+* SDL_RenderDrawRects call. Lines are built as one pixel wide quads and drawn with one SDL_RenderGeometry
+* call per color. The arrays keep their capacity between frames.
+*/
+class DebugDraw {
+public:
+	DebugDraw() = default;
+
+	// Drops the shapes collected so far, the next ones are culled against 'camera'.
+	void begin(const SDL_Rect& camera);
+
+	void line(int x1, int y1, int x2, int y2, SDL_Color color);
+	void rect(const SDL_Rect& rect, SDL_Color color);
+	void fill_rect(const SDL_Rect& rect, SDL_Color color);
+
+	void flush(SDL_Renderer* renderer) const;
+
+	bool empty() const;
+
+private:
+	struct Batch {
+		SDL_Color color{};
+		std::vector<SDL_Rect> fill_rects{};
+		std::vector<SDL_Rect> rects{};
+		std::vector<SDL_Vertex> line_vertices{}; // four per line
+		std::vector<int> line_indices{};         // six per line
+	};
+
+	SDL_Rect camera{};
+	std::vector<Batch> batches{};
+	std::size_t last_batch{};
+
+	Batch& get_batch(SDL_Color color);
+	bool is_visible(int x1, int y1, int x2, int y2) const;
+};
+
+#endif //DEBUG_DRAW_HPP
@@ -0,0 +1,107 @@
+#include "frame_capture.hpp"
+
+#include "../logger/logger.hpp"
+
+#include <SDL2/SDL_image.h>
+
+#include <cstdlib>
+#include <filesystem>
+
+FrameCapture::FrameCapture(const std::string& dump_dir, const std::string& golden_dir, int tolerance) :
+	dump_dir{ dump_dir },
+	golden_dir{ golden_dir },
+	tolerance{ tolerance } {
+
+	if (!dump_dir.empty()) {
+		std::error_code error{};
+		std::filesystem::create_directories(dump_dir, error);
+		if (error) {
+			Logger::err("Failed to create frame dump directory: " + dump_dir);
+		}
+	}
+}
+
+std::string FrameCapture::frame_name(std::uint32_t frame) {
+	std::string number{ std::to_string(frame) };
+	if (number.size() < 5) {
+		number.insert(0, 5 - number.size(), '0');
+	}
+	return "frame_" + number + ".png";
+}
+
+void FrameCapture::capture(SDL_Surface* surface, std::uint32_t frame) {
+	if (surface == nullptr) {
+		return;
+	}
+
+	const std::string name{ frame_name(frame) };
+
+	if (!dump_dir.empty()) {
+		const std::string path{ (std::filesystem::path{ dump_dir } / name).string() };
+		if (IMG_SavePNG(surface, path.c_str()) != 0) {
+			std::string err(SDL_GetError());
+			Logger::err("Failed to save frame to '" + path + "': " + err);
+		}
+	}
+
+	if (golden_dir.empty()) {
+		return;
+	}
+
+	++compared_frames;
+
+	const std::string golden_path{ (std::filesystem::path{ golden_dir } / name).string() };
+	SDL_Surface* golden{ IMG_Load(golden_path.c_str()) };
+
+	if (golden == nullptr) {
+		Logger::err("Missing golden image: " + golden_path);
+		++mismatched_frames;
+		return;
+	}
+
+	const long long mismatched_pixels{ compare(surface, golden) };
+	SDL_FreeSurface(golden);
+
+	if (mismatched_pixels != 0) {
+		++mismatched_frames;
+		Logger::err(
+			"Frame " + std::to_string(frame) + " differs from its golden image: " +
+			(mismatched_pixels < 0 ? std::string{ "size mismatch" } : std::to_string(mismatched_pixels) + " pixels")
+		);
+	}
+}
+
+long long FrameCapture::compare(SDL_Surface* frame, SDL_Surface* golden) const {
+	if (frame->w != golden->w || frame->h != golden->h) {
+		return -1;
+	}
+
+	// Both converted to the same byte order, whatever the formats they were rendered or loaded in
+	SDL_Surface* a{ SDL_ConvertSurfaceFormat(frame, SDL_PIXELFORMAT_RGBA32, 0) };
+	SDL_Surface* b{ SDL_ConvertSurfaceFormat(golden, SDL_PIXELFORMAT_RGBA32, 0) };
+
+	long long mismatched_pixels{ -1 };
+
+	if (a != nullptr && b != nullptr) {
+		mismatched_pixels = 0;
+
+		for (int y{}; y < a->h; ++y) {
+			const Uint8* row_a{ static_cast<const Uint8*>(a->pixels) + static_cast<std::ptrdiff_t>(y) * a->pitch };
+			const Uint8* row_b{ static_cast<const Uint8*>(b->pixels) + static_cast<std::ptrdiff_t>(y) * b->pitch };
+
+			for (int x{}; x < a->w * 4; x += 4) {
+				for (int channel{}; channel < 4; ++channel) {
+					if (std::abs(row_a[x + channel] - row_b[x + channel]) > tolerance) {
+						++mismatched_pixels;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	SDL_FreeSurface(a);
+	SDL_FreeSurface(b);
+
+	return mismatched_pixels;
+}
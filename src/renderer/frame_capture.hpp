@@ -0,0 +1,36 @@
+#ifndef FRAME_CAPTURE_HPP
+#define FRAME_CAPTURE_HPP
+
+#include <SDL2/SDL.h>
+
+#include <cstdint>
+#include <string>
+
+/*
+* Saves the frames rendered into a surface as numbered PNGs (frame_00001.png, ...)
+* and/or compares them against golden images with the same names.
+* Channels may differ by up to 'tolerance' before a pixel counts as mismatched.
+*/
+class FrameCapture {
+public:
+	FrameCapture(const std::string& dump_dir, const std::string& golden_dir, int tolerance = 2);
+
+	void capture(SDL_Surface* surface, std::uint32_t frame);
+
+	std::uint32_t get_compared_frames() const { return compared_frames; }
+	std::uint32_t get_mismatched_frames() const { return mismatched_frames; }
+
+private:
+	std::string dump_dir{};
+	std::string golden_dir{};
+	int tolerance{};
+	std::uint32_t compared_frames{};
+	std::uint32_t mismatched_frames{};
+
+	static std::string frame_name(std::uint32_t frame);
+
+	// Number of pixels differing by more than the tolerance, -1 if the images can't be compared.
+	long long compare(SDL_Surface* frame, SDL_Surface* golden) const;
+};
+
+#endif //FRAME_CAPTURE_HPP
@@ -0,0 +1,130 @@
+#include "glyph_atlas.hpp"
+
+#include "../asset_manager/skyline_packer.hpp"
+#include "../logger/logger.hpp"
+
+#include <utility>
+
+GlyphAtlas::~GlyphAtlas() {
+	SDL_DestroyTexture(texture);
+}
+
+GlyphAtlas::GlyphAtlas(GlyphAtlas&& other) noexcept :
+	texture{ std::exchange(other.texture, nullptr) },
+	glyphs{ other.glyphs },
+	line_height{ other.line_height } {
+}
+
+GlyphAtlas& GlyphAtlas::operator=(GlyphAtlas&& other) noexcept {
+	if (this != &other) {
+		SDL_DestroyTexture(texture);
+		texture = std::exchange(other.texture, nullptr);
+		glyphs = other.glyphs;
+		line_height = other.line_height;
+	}
+	return *this;
+}
+
+bool GlyphAtlas::build(SDL_Renderer* renderer, TTF_Font* font) {
+	if (font == nullptr) {
+		return false;
+	}
+
+	constexpr SDL_Color white{ 255, 255, 255, 255 };
+
+	std::array<SDL_Surface*, last_glyph - first_glyph + 1> surfaces{};
+	SkylinePacker packer{ atlas_width, atlas_height };
+	std::array<SDL_Point, last_glyph - first_glyph + 1> positions{};
+
+	line_height = TTF_FontHeight(font);
+
+	for (std::size_t i{}; i < surfaces.size(); ++i) {
+		const Uint16 character{ static_cast<Uint16>(first_glyph + i) };
+
+		int advance{};
+		TTF_GlyphMetrics(font, character, nullptr, nullptr, nullptr, nullptr, &advance);
+		glyphs[i].advance = advance;
+
+		// Glyph surfaces are a full line high with the glyph at its pen position
+		surfaces[i] = TTF_RenderGlyph_Blended(font, character, white);
+		if (surfaces[i] == nullptr) {
+			continue;
+		}
+
+		if (!packer.insert(surfaces[i]->w + padding, surfaces[i]->h + padding, positions[i])) {
+			Logger::err("Glyph atlas full, glyph " + std::to_string(character) + " skipped");
+			SDL_FreeSurface(surfaces[i]);
+			surfaces[i] = nullptr;
+			continue;
+		}
+
+		glyphs[i].rect = { positions[i].x, positions[i].y, surfaces[i]->w, surfaces[i]->h };
+	}
+
+	SDL_Surface* atlas{
+		SDL_CreateRGBSurfaceWithFormat(0, packer.get_used_width(), packer.get_used_height(), 32, SDL_PIXELFORMAT_RGBA32)
+	};
+
+	if (atlas != nullptr) {
+		for (std::size_t i{}; i < surfaces.size(); ++i) {
+			if (surfaces[i] == nullptr) {
+				continue;
+			}
+
+			SDL_Rect dest_rect{ glyphs[i].rect };
+			SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(surfaces[i], nullptr, atlas, &dest_rect);
+		}
+
+		SDL_DestroyTexture(texture);
+		texture = SDL_CreateTextureFromSurface(renderer, atlas);
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+		SDL_FreeSurface(atlas);
+	}
+
+	for (SDL_Surface* surface : surfaces) {
+		SDL_FreeSurface(surface);
+	}
+
+	if (texture == nullptr) {
+		std::string err(SDL_GetError());
+		Logger::err("Failed to create glyph atlas: " + err);
+		return false;
+	}
+
+	return true;
+}
+
+const GlyphAtlas::Glyph& GlyphAtlas::get_glyph(char c) const {
+	const unsigned char character{ static_cast<unsigned char>(c) };
+
+	if (character < first_glyph || character > last_glyph) {
+		return glyphs['?' - first_glyph];
+	}
+	return glyphs[character - first_glyph];
+}
+
+void GlyphAtlas::draw(RenderSnapshot& snapshot, std::string_view text, float x, float y, SDL_Color color) const {
+	if (texture == nullptr) {
+		return;
+	}
+
+	float pen_x{ x };
+
+	for (const char c : text) {
+		const Glyph& glyph{ get_glyph(c) };
+
+		if (glyph.rect.w > 0) {
+			snapshot.draw(
+				texture,
+				glyph.rect,
+				{ pen_x, y, static_cast<float>(glyph.rect.w), static_cast<float>(glyph.rect.h) },
+				0.0,
+				SDL_FLIP_NONE,
+				color
+			);
+		}
+
+		pen_x += static_cast<float>(glyph.advance);
+	}
+}
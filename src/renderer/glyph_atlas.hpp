@@ -0,0 +1,56 @@
+#ifndef GLYPH_ATLAS_HPP
+#define GLYPH_ATLAS_HPP
+
+#include "render_snapshot.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <array>
+#include <string_view>
+
+/*
+* The printable ASCII glyphs of a font rasterized once, in white, into a single texture.
+* Text is recorded as one quad per glyph into the render snapshot, tinted by the vertex color,
+* so labels cost no rasterization or texture upload per frame.
+*/
+class GlyphAtlas {
+public:
+	static constexpr unsigned char first_glyph{ 32 };
+	static constexpr unsigned char last_glyph{ 126 };
+
+	GlyphAtlas() = default;
+	~GlyphAtlas();
+
+	GlyphAtlas(const GlyphAtlas&) = delete;
+	GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+	GlyphAtlas(GlyphAtlas&& other) noexcept;
+	GlyphAtlas& operator=(GlyphAtlas&& other) noexcept;
+
+	bool build(SDL_Renderer* renderer, TTF_Font* font);
+
+	bool is_valid() const { return texture != nullptr; }
+	int get_line_height() const { return line_height; }
+
+	// Draws one line of text with its top left corner at (x, y).
+	// Characters outside the atlas are drawn as '?'.
+	void draw(RenderSnapshot& snapshot, std::string_view text, float x, float y, SDL_Color color) const;
+
+private:
+	static constexpr int atlas_width{ 512 };
+	static constexpr int atlas_height{ 512 };
+	static constexpr int padding{ 1 };
+
+	struct Glyph {
+		SDL_Rect rect{};
+		int advance{};
+	};
+
+	SDL_Texture* texture{ nullptr };
+	std::array<Glyph, last_glyph - first_glyph + 1> glyphs{};
+	int line_height{};
+
+	const Glyph& get_glyph(char c) const;
+};
+
+#endif //GLYPH_ATLAS_HPP
@@ -0,0 +1,57 @@
+#ifndef RADIX_SORT_HPP
+#define RADIX_SORT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/*
+* Stable LSD radix sort of 64 bit keys, one byte per pass. The histograms of all the
+* passes are counted in a single read, passes where every key has the same byte are skipped,
+* so keys that only use their low bytes cost only a few passes.
+* 'scratch' is resized to the key count and can be reused between calls.
+*/
+inline void radix_sort(std::vector<std::uint64_t>& keys, std::vector<std::uint64_t>& scratch) {
+	constexpr std::size_t passes{ sizeof(std::uint64_t) };
+
+	const std::size_t count{ keys.size() };
+	if (count < 2) {
+		return;
+	}
+
+	std::array<std::array<std::size_t, 256>, passes> histograms{};
+	for (const std::uint64_t key : keys) {
+		for (std::size_t pass{}; pass < passes; ++pass) {
+			++histograms[pass][(key >> (pass * 8)) & 0xFF];
+		}
+	}
+
+	scratch.resize(count);
+
+	for (std::size_t pass{}; pass < passes; ++pass) {
+		std::array<std::size_t, 256>& histogram{ histograms[pass] };
+
+		const std::size_t shift{ pass * 8 };
+		if (histogram[(keys.front() >> shift) & 0xFF] == count) {
+			continue;
+		}
+
+		// Counts to starting offsets
+		std::size_t offset{};
+		for (std::size_t& bucket : histogram) {
+			const std::size_t bucket_count{ bucket };
+			bucket = offset;
+			offset += bucket_count;
+		}
+
+		for (const std::uint64_t key : keys) {
+			scratch[histogram[(key >> shift) & 0xFF]++] = key;
+		}
+
+		keys.swap(scratch);
+	}
+}
+
+#endif //RADIX_SORT_HPP
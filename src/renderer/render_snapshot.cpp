@@ -0,0 +1,87 @@
+#include "render_snapshot.hpp"
+
+void RenderSnapshot::clear() {
+	camera = {};
+	commands.clear();
+
+	quad_textures.clear();
+	quad_src_rects.clear();
+	quad_dest_rects.clear();
+	quad_rotations.clear();
+	quad_flips.clear();
+	quad_colors.clear();
+
+	used_debug_layers = 0;
+}
+
+void RenderSnapshot::draw(
+	SDL_Texture* texture,
+	const SDL_Rect& src_rect,
+	const SDL_FRect& dest_rect,
+	double rotation,
+	SDL_RendererFlip flip,
+	SDL_Color color
+) {
+	if (!texture) {
+		return;
+	}
+
+	push_command(CommandType::Quads, quad_textures.size());
+
+	quad_textures.push_back(texture);
+	quad_src_rects.push_back(src_rect);
+	quad_dest_rects.push_back(dest_rect);
+	quad_rotations.push_back(rotation);
+	quad_flips.push_back(flip);
+	quad_colors.push_back(color);
+}
+
+DebugDraw& RenderSnapshot::debug_draw() {
+	if (!commands.empty() && commands.back().type == CommandType::DebugLayer) {
+		return debug_layers[commands.back().first];
+	}
+
+	if (used_debug_layers == debug_layers.size()) {
+		debug_layers.emplace_back();
+	}
+
+	commands.push_back({ CommandType::DebugLayer, static_cast<std::uint32_t>(used_debug_layers), 1 });
+
+	DebugDraw& layer{ debug_layers[used_debug_layers++] };
+	layer.begin(camera);
+	return layer;
+}
+
+void RenderSnapshot::push_command(CommandType type, std::size_t index) {
+	if (!commands.empty() && commands.back().type == type) {
+		++commands.back().count;
+		return;
+	}
+
+	commands.push_back({ type, static_cast<std::uint32_t>(index), 1 });
+}
+
+void RenderSnapshot::submit(SDL_Renderer* renderer, SpriteBatch& sprite_batch) const {
+	for (const Command& command : commands) {
+		const std::size_t first{ command.first };
+		const std::size_t last{ first + command.count };
+
+		if (command.type == CommandType::Quads) {
+			sprite_batch.begin(renderer);
+			for (std::size_t i{ first }; i < last; ++i) {
+				sprite_batch.draw(
+					quad_textures[i],
+					quad_src_rects[i],
+					quad_dest_rects[i],
+					quad_rotations[i],
+					quad_flips[i],
+					quad_colors[i]
+				);
+			}
+			sprite_batch.end();
+			continue;
+		}
+
+		debug_layers[first].flush(renderer);
+	}
+}
@@ -0,0 +1,81 @@
+#ifndef RENDER_SNAPSHOT_HPP
+#define RENDER_SNAPSHOT_HPP
+
+#include "debug_draw.hpp"
+#include "sprite_batch.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+* Everything a frame draws, recorded by the render systems at the end of an update:
+* textured quads (sprites, glyphs) stored as parallel arrays and debug draw layers
+* (lines and rects batched per color), plus the runs of each kind in drawing order.
+* The arrays keep their capacity across frames, so once warmed up recording doesn't allocate
+* and handing a snapshot over to the thread drawing it is just a matter of swapping indices.
+*/
+class RenderSnapshot {
+public:
+	RenderSnapshot() = default;
+
+	RenderSnapshot(const RenderSnapshot&) = delete;
+	RenderSnapshot& operator=(const RenderSnapshot&) = delete;
+
+	// Camera the snapshot was recorded with, for what is drawn outside of it (the tilemap).
+	SDL_Rect camera{};
+
+	void clear();
+
+	// Same arguments as SpriteBatch::draw.
+	void draw(
+		SDL_Texture* texture,
+		const SDL_Rect& src_rect,
+		const SDL_FRect& dest_rect,
+		double rotation = 0.0,
+		SDL_RendererFlip flip = SDL_FLIP_NONE,
+		SDL_Color color = { 255, 255, 255, 255 }
+	);
+
+	// Layer for the untextured shapes recorded next, in world space and culled against the camera.
+	// Consecutive calls return the same layer until a quad is drawn.
+	DebugDraw& debug_draw();
+
+	// Replays the snapshot, runs of quads go through the sprite batch.
+	void submit(SDL_Renderer* renderer, SpriteBatch& sprite_batch) const;
+
+	std::size_t get_quad_count() const { return quad_textures.size(); }
+
+private:
+	enum class CommandType : std::uint8_t {
+		Quads,
+		DebugLayer
+	};
+
+	struct Command {
+		CommandType type{};
+		std::uint32_t first{};
+		std::uint32_t count{};
+	};
+
+	std::vector<Command> commands{};
+
+	//Quads
+	std::vector<SDL_Texture*> quad_textures{};
+	std::vector<SDL_Rect> quad_src_rects{};
+	std::vector<SDL_FRect> quad_dest_rects{};
+	std::vector<double> quad_rotations{};
+	std::vector<SDL_RendererFlip> quad_flips{};
+	std::vector<SDL_Color> quad_colors{};
+
+	//Debug layers, reused from one frame to the next
+	std::vector<DebugDraw> debug_layers{};
+	std::size_t used_debug_layers{};
+
+	// Extends the last command if it has the same type, element 'index' being the next of its run.
+	void push_command(CommandType type, std::size_t index);
+};
+
+#endif //RENDER_SNAPSHOT_HPP
@@ -0,0 +1,102 @@
+#include "sprite_batch.hpp"
+
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+void SpriteBatch::begin(SDL_Renderer* renderer) {
+	this->renderer = renderer;
+	texture = nullptr;
+	vertices.clear();
+	draw_calls = 0;
+}
+
+void SpriteBatch::draw(
+	SDL_Texture* texture,
+	const SDL_Rect& src_rect,
+	const SDL_FRect& dest_rect,
+	double rotation,
+	SDL_RendererFlip flip,
+	SDL_Color color
+) {
+	if (!texture) {
+		return;
+	}
+
+	if (texture != this->texture) {
+		flush();
+		set_texture(texture);
+	}
+
+	float u1{ static_cast<float>(src_rect.x) / texture_width };
+	float v1{ static_cast<float>(src_rect.y) / texture_height };
+	float u2{ static_cast<float>(src_rect.x + src_rect.w) / texture_width };
+	float v2{ static_cast<float>(src_rect.y + src_rect.h) / texture_height };
+
+	if (flip & SDL_FLIP_HORIZONTAL) {
+		std::swap(u1, u2);
+	}
+	if (flip & SDL_FLIP_VERTICAL) {
+		std::swap(v1, v2);
+	}
+
+	const float half_w{ dest_rect.w * 0.5f };
+	const float half_h{ dest_rect.h * 0.5f };
+	const float center_x{ dest_rect.x + half_w };
+	const float center_y{ dest_rect.y + half_h };
+
+	// Corners relative to the center: top left, top right, bottom right, bottom left
+	SDL_FPoint corners[4]{ { -half_w, -half_h }, { half_w, -half_h }, { half_w, half_h }, { -half_w, half_h } };
+
+	if (rotation != 0.0) {
+		const double radians{ rotation * std::numbers::pi / 180.0 };
+		const float cos_a{ static_cast<float>(std::cos(radians)) };
+		const float sin_a{ static_cast<float>(std::sin(radians)) };
+
+		for (SDL_FPoint& corner : corners) {
+			corner = { corner.x * cos_a - corner.y * sin_a, corner.x * sin_a + corner.y * cos_a };
+		}
+	}
+
+	const SDL_FPoint tex_coords[4]{ { u1, v1 }, { u2, v1 }, { u2, v2 }, { u1, v2 } };
+
+	for (int i{}; i < 4; ++i) {
+		vertices.push_back({ { center_x + corners[i].x, center_y + corners[i].y }, color, tex_coords[i] });
+	}
+}
+
+void SpriteBatch::flush() {
+	if (vertices.empty() || !renderer) {
+		return;
+	}
+
+	const std::size_t quad_count{ vertices.size() / 4 };
+
+	while (indices.size() < quad_count * 6) {
+		const int first{ static_cast<int>(indices.size() / 6 * 4) };
+		indices.insert(indices.end(), { first, first + 1, first + 2, first + 2, first + 3, first });
+	}
+
+	SDL_RenderGeometry(
+		renderer,
+		texture,
+		vertices.data(),
+		static_cast<int>(vertices.size()),
+		indices.data(),
+		static_cast<int>(quad_count * 6)
+	);
+
+	++draw_calls;
+	vertices.clear();
+}
+
+void SpriteBatch::set_texture(SDL_Texture* texture) {
+	this->texture = texture;
+
+	int width{};
+	int height{};
+	SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
+
+	texture_width = width > 0 ? static_cast<float>(width) : 1.0f;
+	texture_height = height > 0 ? static_cast<float>(height) : 1.0f;
+}
@@ -0,0 +1,53 @@
+#ifndef SPRITE_BATCH_HPP
+#define SPRITE_BATCH_HPP
+
+#include <SDL2/SDL.h>
+
+#include <cstddef>
+#include <vector>
+
+/*
+* Accumulates textured quads and draws all the consecutive ones sharing a texture
+* with a single SDL_RenderGeometry call. Rotation and flips are applied to the vertices
+* on the CPU, matching SDL_RenderCopyEx: clockwise degrees around the destination center.
+* Works with any renderer backend, the software one included.
+*/
+class SpriteBatch {
+public:
+	SpriteBatch() = default;
+
+	SpriteBatch(const SpriteBatch&) = delete;
+	SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+	void begin(SDL_Renderer* renderer);
+
+	void draw(
+		SDL_Texture* texture,
+		const SDL_Rect& src_rect,
+		const SDL_FRect& dest_rect,
+		double rotation = 0.0,
+		SDL_RendererFlip flip = SDL_FLIP_NONE,
+		SDL_Color color = { 255, 255, 255, 255 }
+	);
+
+	// Must be called before anything else is drawn with the renderer.
+	void flush();
+	void end() { flush(); }
+
+	// Draw calls issued since begin, for profiling.
+	std::size_t get_draw_calls() const { return draw_calls; }
+
+private:
+	SDL_Renderer* renderer{ nullptr };
+	SDL_Texture* texture{ nullptr };
+	float texture_width{ 1.0f };
+	float texture_height{ 1.0f };
+	std::size_t draw_calls{};
+
+	std::vector<SDL_Vertex> vertices{};
+	std::vector<int> indices{}; // Same pattern for every quad, only grows
+
+	void set_texture(SDL_Texture* texture);
+};
+
+#endif //SPRITE_BATCH_HPP
@@ -0,0 +1,170 @@
+#include "tilemap_renderer.hpp"
+
+#include "../logger/logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+TilemapRenderer::~TilemapRenderer() {
+	clear();
+}
+
+void TilemapRenderer::clear() {
+	for (SDL_Texture* chunk : chunks) {
+		SDL_DestroyTexture(chunk);
+	}
+
+	chunks.clear();
+	chunk_cols = 0;
+	chunk_rows = 0;
+	is_dirty = true;
+}
+
+void TilemapRenderer::render(SDL_Renderer* renderer, const AssetManager& asset_manager, const Tilemap& tilemap, SpriteBatch& sprite_batch, const SDL_Rect& camera) {
+	const TextureRegion& sheet{ asset_manager.get_region(tilemap.get_texture()) };
+
+	if (sheet.texture == nullptr || tilemap.get_rows() <= 0 || tilemap.get_cols() <= 0) {
+		return;
+	}
+
+	if (is_dirty || tilemap_version != tilemap.get_version()) {
+		build(renderer, sheet, tilemap, sprite_batch);
+	}
+
+	const double tile_size{ tilemap.get_tile_world_size() };
+	const double chunk_size{ tile_size * chunk_tiles };
+
+	// Chunks overlapping the camera
+	const int first_col{ std::max(static_cast<int>(std::floor(camera.x / chunk_size)), 0) };
+	const int first_row{ std::max(static_cast<int>(std::floor(camera.y / chunk_size)), 0) };
+	const int last_col{ std::min(static_cast<int>(std::ceil((camera.x + camera.w) / chunk_size)), chunk_cols) };
+	const int last_row{ std::min(static_cast<int>(std::ceil((camera.y + camera.h) / chunk_size)), chunk_rows) };
+
+	if (chunks.empty()) {
+		const int tiles_first_col{ first_col * chunk_tiles };
+		const int tiles_first_row{ first_row * chunk_tiles };
+
+		sprite_batch.begin(renderer);
+		draw_tiles(
+			sheet,
+			tilemap,
+			sprite_batch,
+			tiles_first_col,
+			tiles_first_row,
+			std::min(last_col * chunk_tiles, tilemap.get_cols()),
+			std::min(last_row * chunk_tiles, tilemap.get_rows()),
+			tiles_first_col * tile_size - camera.x,
+			tiles_first_row * tile_size - camera.y,
+			tile_size
+		);
+		sprite_batch.end();
+		return;
+	}
+
+	for (int row{ first_row }; row < last_row; ++row) {
+		for (int col{ first_col }; col < last_col; ++col) {
+			// Edges come from tile positions so neighbouring chunks never leave a seam
+			const int end_col{ std::min((col + 1) * chunk_tiles, tilemap.get_cols()) };
+			const int end_row{ std::min((row + 1) * chunk_tiles, tilemap.get_rows()) };
+
+			const int x1{ static_cast<int>(std::round(col * chunk_size - camera.x)) };
+			const int y1{ static_cast<int>(std::round(row * chunk_size - camera.y)) };
+			const int x2{ static_cast<int>(std::round(end_col * tile_size - camera.x)) };
+			const int y2{ static_cast<int>(std::round(end_row * tile_size - camera.y)) };
+
+			const SDL_Rect dest_rect{ x1, y1, x2 - x1, y2 - y1 };
+
+			SDL_RenderCopy(renderer, chunks[static_cast<std::size_t>(row * chunk_cols + col)], nullptr, &dest_rect);
+		}
+	}
+}
+
+void TilemapRenderer::build(SDL_Renderer* renderer, const TextureRegion& sheet, const Tilemap& tilemap, SpriteBatch& sprite_batch) {
+	clear();
+
+	is_dirty = false;
+	tilemap_version = tilemap.get_version();
+	chunk_cols = (tilemap.get_cols() + chunk_tiles - 1) / chunk_tiles;
+	chunk_rows = (tilemap.get_rows() + chunk_tiles - 1) / chunk_tiles;
+
+	if (!SDL_RenderTargetSupported(renderer)) {
+		Logger::log("Render targets not supported, the tilemap is drawn tile by tile");
+		return;
+	}
+
+	const int tile_size{ tilemap.get_tile_size() };
+
+	// Chunks are baked at the tile sheet resolution, the map scale is applied when blitting
+	for (int row{}; row < chunk_rows; ++row) {
+		for (int col{}; col < chunk_cols; ++col) {
+			const int first_col{ col * chunk_tiles };
+			const int first_row{ row * chunk_tiles };
+			const int end_col{ std::min(first_col + chunk_tiles, tilemap.get_cols()) };
+			const int end_row{ std::min(first_row + chunk_tiles, tilemap.get_rows()) };
+
+			SDL_Texture* chunk{
+				SDL_CreateTexture(
+					renderer,
+					SDL_PIXELFORMAT_ARGB8888,
+					SDL_TEXTUREACCESS_TARGET,
+					(end_col - first_col) * tile_size,
+					(end_row - first_row) * tile_size
+				)
+			};
+
+			if (chunk == nullptr) {
+				std::string err(SDL_GetError());
+				Logger::err("Failed to create tilemap chunk texture: " + err);
+				clear();
+				is_dirty = false;
+				return;
+			}
+
+			SDL_SetTextureBlendMode(chunk, SDL_BLENDMODE_BLEND);
+			SDL_SetRenderTarget(renderer, chunk);
+			SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+			SDL_RenderClear(renderer);
+
+			sprite_batch.begin(renderer);
+			draw_tiles(sheet, tilemap, sprite_batch, first_col, first_row, end_col, end_row, 0.0, 0.0, tile_size);
+			sprite_batch.end();
+
+			chunks.push_back(chunk);
+		}
+	}
+
+	SDL_SetRenderTarget(renderer, nullptr);
+
+	Logger::log("Tilemap baked into " + std::to_string(chunks.size()) + " chunks");
+}
+
+void TilemapRenderer::draw_tiles(
+	const TextureRegion& sheet,
+	const Tilemap& tilemap,
+	SpriteBatch& sprite_batch,
+	int first_col, int first_row, int last_col, int last_row,
+	double x, double y, double tile_size
+) {
+	const int sheet_tile_size{ tilemap.get_tile_size() };
+
+	for (int row{ first_row }; row < last_row; ++row) {
+		for (int col{ first_col }; col < last_col; ++col) {
+			const Tilemap::Tile& tile{ tilemap.get_tile(col, row) };
+
+			const SDL_Rect src_rect{
+				sheet.rect.x + tile.src_col * sheet_tile_size,
+				sheet.rect.y + tile.src_row * sheet_tile_size,
+				sheet_tile_size,
+				sheet_tile_size
+			};
+
+			// Same rounding on both edges keeps the tiles gapless
+			const float x1{ static_cast<float>(std::round(x + (col - first_col) * tile_size)) };
+			const float y1{ static_cast<float>(std::round(y + (row - first_row) * tile_size)) };
+			const float x2{ static_cast<float>(std::round(x + (col - first_col + 1) * tile_size)) };
+			const float y2{ static_cast<float>(std::round(y + (row - first_row + 1) * tile_size)) };
+
+			sprite_batch.draw(sheet.texture, src_rect, { x1, y1, x2 - x1, y2 - y1 });
+		}
+	}
+}
@@ -0,0 +1,57 @@
+#ifndef TILEMAP_RENDERER_HPP
+#define TILEMAP_RENDERER_HPP
+
+#include "sprite_batch.hpp"
+#include "../asset_manager/asset_manager.hpp"
+#include "../tilemap/tilemap.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <cstdint>
+#include <vector>
+
+/*
+* Draws the tilemap as fixed-size chunks of tiles, each baked once into a render-target
+* texture, so a frame only blits the chunks overlapping the camera.
+* Chunks are rebuilt when the tilemap changes or the render targets are lost
+* (SDL_RENDER_TARGETS_RESET). Without render target support, the visible tiles are
+* drawn directly through the sprite batch.
+*/
+class TilemapRenderer {
+public:
+	static constexpr int chunk_tiles{ 16 };
+
+	TilemapRenderer() = default;
+	~TilemapRenderer();
+
+	TilemapRenderer(const TilemapRenderer&) = delete;
+	TilemapRenderer& operator=(const TilemapRenderer&) = delete;
+
+	void render(SDL_Renderer* renderer, const AssetManager& asset_manager, const Tilemap& tilemap, SpriteBatch& sprite_batch, const SDL_Rect& camera);
+
+	// Chunks are baked again on the next render.
+	void invalidate() { is_dirty = true; }
+
+	// Must be called before the renderer owning the chunk textures is destroyed.
+	void clear();
+
+private:
+	std::vector<SDL_Texture*> chunks{};
+	int chunk_cols{};
+	int chunk_rows{};
+	std::uint32_t tilemap_version{};
+	bool is_dirty{ true };
+
+	void build(SDL_Renderer* renderer, const TextureRegion& sheet, const Tilemap& tilemap, SpriteBatch& sprite_batch);
+
+	// Draws the tiles in [first_col, last_col) x [first_row, last_row), the first one at (x, y).
+	static void draw_tiles(
+		const TextureRegion& sheet,
+		const Tilemap& tilemap,
+		SpriteBatch& sprite_batch,
+		int first_col, int first_row, int last_col, int last_row,
+		double x, double y, double tile_size
+	);
+};
+
+#endif //TILEMAP_RENDERER_HPP
@@ -2,9 +2,19 @@
 #define ANIMATION_SYSTEM_HPP
 
 #include "../ecs/ecs.hpp"
+#include "../asset_manager/asset_manager.hpp"
 #include "../components/animation_component.hpp"
 #include "../components/sprite_component.hpp"
+#include "../event_manager/event_manager.hpp"
+#include "../events/animation_event.hpp"
 
+#include <cstddef>
+#include <vector>
+
+/*
+* Entities are grouped by clip so every clip is read once per step, then all its entities
+* advance their time and pick their precomputed frame rectangle (a multiply for uniform clips).
+*/
 class AnimationSystem : public System {
 public:
 	AnimationSystem() {
@@ -12,23 +22,84 @@ public:
 		require_component<SpriteComponent>();
 	}
 
-	void update(double delta_time) {
+	void update(double delta_time, const AssetManager& asset_manager, EventManager& event_manager) {
+		for (std::vector<Entity>& bucket : clip_entities) {
+			bucket.clear();
+		}
+		clip_entities.resize(asset_manager.get_animation_clip_count());
 
 		for (const Entity& entity : get_entities()) {
-			SpriteComponent& sprite{ entity.get_component<SpriteComponent>() };
+			const AnimationComponent& animation{ entity.get_component<AnimationComponent>() };
+			if (animation.clip.is_valid() && static_cast<std::size_t>(animation.clip.index) < clip_entities.size()) {
+				clip_entities[static_cast<std::size_t>(animation.clip.index)].push_back(entity);
+			}
+		}
+
+		for (std::size_t i{}; i < clip_entities.size(); ++i) {
+			if (!clip_entities[i].empty()) {
+				const AnimationClipHandle handle{ static_cast<int>(i) };
+				update_clip(handle, asset_manager.get_animation_clip(handle), clip_entities[i], delta_time, event_manager);
+			}
+		}
+	}
+
+private:
+	std::vector<std::vector<Entity>> clip_entities{};
+
+	void update_clip(
+		AnimationClipHandle handle,
+		const AnimationClip& clip,
+		const std::vector<Entity>& entities,
+		double delta_time,
+		EventManager& event_manager
+	) {
+		const double duration{ clip.duration };
+
+		for (const Entity& entity : entities) {
 			AnimationComponent& animation{ entity.get_component<AnimationComponent>() };
+			SpriteComponent& sprite{ entity.get_component<SpriteComponent>() };
 
-			bool animate{ animation.loop || animation.current_frame < animation.frames - 1 };
-			if (animate) {
-				animation.elapsed_seconds += delta_time;
+			const double previous{ animation.time };
+			double time{ previous + delta_time };
+			bool wrapped{ false };
 
-				if (animation.elapsed_seconds >= animation.frame_delay) {
-					++animation.current_frame;
-					animation.current_frame = animation.current_frame % animation.frames;
-					animation.elapsed_seconds -= animation.frame_delay;
+			if (time >= duration) {
+				if (clip.loop && duration > 0.0) {
+					while (time >= duration) {
+						time -= duration;
+					}
+					wrapped = true;
+				}
+				else {
+					time = duration;
 				}
+			}
+
+			if (!clip.events.empty() && time != previous) {
+				enqueue_events(entity, handle, clip, previous, time, wrapped, event_manager);
+			}
+
+			animation.time = time;
+			sprite.src_rect = clip.frames[clip.frame_at(time)];
+		}
+	}
+
+	// Events in (previous, time], or in (previous, duration] and [0, time] after a loop.
+	void enqueue_events(
+		const Entity& entity,
+		AnimationClipHandle handle,
+		const AnimationClip& clip,
+		double previous,
+		double time,
+		bool wrapped,
+		EventManager& event_manager
+	) {
+		for (std::size_t i{}; i < clip.events.size(); ++i) {
+			const double event_time{ clip.events[i].time };
+			const bool reached{ wrapped ? event_time > previous || event_time <= time : event_time > previous && event_time <= time };
 
-				sprite.src_rect.x = animation.current_frame * sprite.width;
+			if (reached) {
+				event_manager.enqueue<AnimationEvent>(entity, handle, static_cast<int>(i));
 			}
 		}
 	}
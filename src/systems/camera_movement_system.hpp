@@ -15,12 +15,14 @@ public:
 		require_component<TransformComponent>();
 	}
 
-	void update(SDL_Rect* camera) {
+	// Follows the drawn (interpolated) position, so the followed entity doesn't jitter on screen.
+	void update(SDL_Rect* camera, double alpha) {
 		for (Entity& entity : get_entities()) {
 			TransformComponent& transfrom{ entity.get_component<TransformComponent>() };
+			const glm::dvec2 position{ transfrom.interpolate(alpha) };
 
-			double entity_x{ static_cast<double>(transfrom.position.x) };
-			double entity_y{ static_cast<double>(transfrom.position.y) };
+			double entity_x{ position.x };
+			double entity_y{ position.y };
 
 			double w{ static_cast<double>(camera->w) };
 			double h{ static_cast<double>(camera->h) };
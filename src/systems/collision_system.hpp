@@ -2,13 +2,51 @@
 #define COLLISION_SYSTEM_HPP
 
 #include "../ecs/ecs.hpp"
+#include "../collision/aabb_kernel.hpp"
+#include "../collision/collider_bounds.hpp"
+#include "../collision/contact_cache.hpp"
+#include "../collision/contact_pair.hpp"
+#include "../collision/spatial_query.hpp"
+#include "../collision/swept_aabb.hpp"
 #include "../components/box_collider_component.hpp"
+#include "../components/rigidbody_component.hpp"
 #include "../components/transform_component.hpp"
 #include "../event_manager/event_manager.hpp"
 #include "../events/collision_event.hpp"
+#include "../events/collision_exit_event.hpp"
+#include "../events/collision_stay_event.hpp"
+#include "../events/tile_collision_event.hpp"
+#include "../thread_pool/thread_pool.hpp"
+#include "../tilemap/tilemap.hpp"
 
-#include <unordered_set>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+#include <cstdint>
 
+/*
+* Broadphase: sweep and prune, colliders are sorted by min x and each one is only
+* tested (with the SIMD kernel) against the following run that starts before its max x.
+* Narrowphase: continuous colliders are tested with a swept AABB over the last movement
+* step, against the movement of the other collider when it has a rigidbody too, so fast
+* projectiles can't tunnel through thin targets at low frame rates.
+* Contacts are tracked across frames: CollisionEvent is emitted when a pair starts
+* touching, CollisionStayEvent while it keeps touching and CollisionExitEvent when it stops.
+* The pair search is split in contiguous slices across the thread pool, each slice writes
+* into its own buffer and the buffers are merged in slice order, which is exactly the
+* single-threaded order, so events are dispatched deterministically.
+* The sorted bounds double as the acceleration structure for the spatial queries,
+* which see the colliders as of the last update.
+* Moving colliders (with a rigidbody) are also tested against the solid tiles of the
+* tilemap by looking up only the cells their box covers, tiles never become entities.
+* Events are queued rather than dispatched, handlers run in bulk on EventManager::dispatch_all.
+* Every frame the touching pairs are also published as one contiguous stream sorted by
+* group pair (get_contacts), for systems that rather consume them in bulk than per event.
+*/
 class CollisionSystem : public System {
 public:
 	CollisionSystem() {
@@ -16,65 +54,438 @@ public:
 		require_component<TransformComponent>();
 	}
 
-	void update(EventManager& event_manager) {
-
-		std::unordered_set<int> colliding_entities{};
+	void update(EventManager& event_manager, ThreadPool& thread_pool, const Tilemap& tilemap) {
 
 		auto& entities{ get_entities() };
 
-		for (auto i{ entities.begin() }; i != entities.end(); ++i) {
-			Entity& e{ *i };
+		gather_bounds(entities);
+		sort_bounds();
+		find_pairs(thread_pool);
+
+		colliding.assign(entities.size(), 0);
+		contacts.begin_frame();
+		contact_stream.clear();
+
+		for (const PairBuffer& buffer : buffers) {
+			for (const auto& [a, b] : buffer.pairs) {
+				bool is_new{ contacts.touch(entities[a].get_id(), entities[b].get_id()) };
+
+				if (is_new) {
+					event_manager.enqueue<CollisionEvent>(entities[a], entities[b]);
+				}
+				else {
+					event_manager.enqueue<CollisionStayEvent>(entities[a], entities[b]);
+				}
+
+				publish(entities[a], entities[b], is_new);
+
+				colliding[a] = 1;
+				colliding[b] = 1;
+			}
+		}
+
+		contacts.end_frame([this, &entities, &event_manager](int a, int b) {
+			int a_index{ find_index(a) };
+			int b_index{ find_index(b) };
+
+			// Pairs that ended because an entity was destroyed are dropped silently
+			if (a_index >= 0 && b_index >= 0) {
+				event_manager.enqueue<CollisionExitEvent>(
+					entities[static_cast<std::size_t>(a_index)],
+					entities[static_cast<std::size_t>(b_index)]
+				);
+			}
+		});
+
+		std::stable_sort(contact_stream.begin(), contact_stream.end(), contact_pair::group_less);
+
+		if (tilemap.has_solidity()) {
+			collide_with_tiles(entities, event_manager, thread_pool, tilemap);
+		}
+
+		for (std::size_t i{}; i < entities.size(); ++i) {
+			entities[i].get_component<BoxColliderComponent>().is_colliding = colliding[i] != 0;
+		}
+	}
+
+	// Touching pairs of the last update, sorted by group pair.
+	std::span<const ContactPair> get_contacts() const { return contact_stream; }
+
+	// Appends the entities whose collider overlaps the box, returns how many were added.
+	std::size_t query_aabb(
+		double x1,
+		double y1,
+		double x2,
+		double y2,
+		const SpatialQueryFilter& filter,
+		std::vector<Entity>& results
+	) {
+		std::size_t count{};
+
+		find_candidates(x1, y1, x2, y2);
+		for (std::uint32_t i : query_hits) {
+			if (filter.accepts(sorted_entities[i])) {
+				results.push_back(sorted_entities[i]);
+				++count;
+			}
+		}
+
+		return count;
+	}
+
+	// Appends the entities whose collider touches the circle, returns how many were added.
+	std::size_t query_radius(
+		double x,
+		double y,
+		double radius,
+		const SpatialQueryFilter& filter,
+		std::vector<Entity>& results
+	) {
+		std::size_t count{};
+
+		find_candidates(x - radius, y - radius, x + radius, y + radius);
+		for (std::uint32_t i : query_hits) {
+			double closest_x{ std::clamp(x, static_cast<double>(bounds.min_x[i]), static_cast<double>(bounds.max_x[i])) };
+			double closest_y{ std::clamp(y, static_cast<double>(bounds.min_y[i]), static_cast<double>(bounds.max_y[i])) };
+			double dx{ x - closest_x };
+			double dy{ y - closest_y };
+
+			if (dx * dx + dy * dy <= radius * radius && filter.accepts(sorted_entities[i])) {
+				results.push_back(sorted_entities[i]);
+				++count;
+			}
+		}
+
+		return count;
+	}
+
+	// Returns the closest collider hit by the ray within max_distance, direction doesn't need to be normalized.
+	std::optional<RaycastHit> raycast(
+		double x,
+		double y,
+		double direction_x,
+		double direction_y,
+		double max_distance,
+		const SpatialQueryFilter& filter
+	) {
+		double length{ std::sqrt(direction_x * direction_x + direction_y * direction_y) };
+		if (length == 0.0) {
+			return std::nullopt;
+		}
+
+		double dx{ direction_x / length };
+		double dy{ direction_y / length };
+		double end_x{ x + dx * max_distance };
+		double end_y{ y + dy * max_distance };
+
+		find_candidates(std::min(x, end_x), std::min(y, end_y), std::max(x, end_x), std::max(y, end_y));
+
+		std::optional<RaycastHit> closest{};
+		for (std::uint32_t i : query_hits) {
+			double entry{ 0.0 };
+			double exit{ max_distance };
+
+			if (!clip_ray(x, dx, bounds.min_x[i], bounds.max_x[i], entry, exit) ||
+				!clip_ray(y, dy, bounds.min_y[i], bounds.max_y[i], entry, exit)) {
+				continue;
+			}
+
+			if ((!closest || entry < closest->distance) && filter.accepts(sorted_entities[i])) {
+				closest = RaycastHit{ sorted_entities[i], entry };
+			}
+		}
+
+		return closest;
+	}
+
+private:
+	// Below this many colliders the pair search isn't worth waking the workers for
+	static constexpr std::size_t min_parallel_colliders{ 256 };
+
+	struct PairBuffer {
+		std::vector<std::uint32_t> hits{};
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs{};
+	};
+
+	ColliderBounds unsorted_bounds{};
+	ColliderBounds bounds{};
+	std::vector<std::uint32_t> order{};
+	std::vector<SweptBox> swept{};
+	std::vector<std::uint8_t> continuous{};
+	std::vector<std::uint8_t> dynamic{};
+	std::vector<std::uint8_t> touching_tiles{};
+	std::vector<Entity> sorted_entities{};
+	float max_width{};
+	std::vector<std::uint32_t> query_hits{};
+	std::vector<PairBuffer> buffers{};
+	std::vector<std::uint8_t> colliding{};
+	std::vector<int> entity_index{};
+	ContactCache contacts{};
+	std::vector<ContactPair> contact_stream{};
+
+	void publish(const Entity& a, const Entity& b, bool is_new) {
+		int a_group{ a.get_group_id() };
+		int b_group{ b.get_group_id() };
+
+		if (a_group <= b_group) {
+			contact_stream.push_back({ a, b, a_group, b_group, is_new });
+		}
+		else {
+			contact_stream.push_back({ b, a, b_group, a_group, is_new });
+		}
+	}
+
+	int find_index(int entity_id) const {
+		std::size_t id{ static_cast<std::size_t>(entity_id) };
+		return id < entity_index.size() ? entity_index[id] : -1;
+	}
+
+	// Bounds are truncated to whole pixels like the old integer test.
+	// Continuous colliders use the box covering their whole movement step in the broadphase.
+	// Every collider with a rigidbody gets a swept box over its movement step for the narrowphase.
+	void gather_bounds(const std::vector<Entity>& entities) {
+		unsorted_bounds.clear();
+		unsorted_bounds.reserve(entities.size());
+		swept.clear();
+		continuous.clear();
+		dynamic.clear();
+		std::fill(entity_index.begin(), entity_index.end(), -1);
+
+		for (const Entity& e : entities) {
+			std::size_t id{ static_cast<std::size_t>(e.get_id()) };
+			if (id >= entity_index.size()) {
+				entity_index.resize(id + 1, -1);
+			}
+			entity_index[id] = static_cast<int>(continuous.size());
 
 			const TransformComponent& transform{ e.get_component<TransformComponent>() };
-			BoxColliderComponent& collider{ e.get_component<BoxColliderComponent>() };
+			const BoxColliderComponent& collider{ e.get_component<BoxColliderComponent>() };
 
-			for (auto j{ i + 1 }; j != entities.end(); ++j) {
-				Entity& other{ *j };
+			double x{ transform.position.x + collider.offset.x };
+			double y{ transform.position.y + collider.offset.y };
+			double w{ static_cast<double>(collider.width) };
+			double h{ static_cast<double>(collider.height) };
 
-				const TransformComponent& other_transform{ other.get_component<TransformComponent>() };
-				BoxColliderComponent& other_collider{ other.get_component<BoxColliderComponent>() };
+			double x1{ x };
+			double y1{ y };
 
-				bool is_colliding{ check_collision(transform, collider, other_transform, other_collider) };
+			const bool is_dynamic{ e.has_component<RigidbodyComponent>() };
 
-				if (is_colliding) {
-					event_manager.emit<CollisionEvent>(e, other);
+			if (is_dynamic) {
+				double start_x{ transform.previous_position.x + collider.offset.x };
+				double start_y{ transform.previous_position.y + collider.offset.y };
 
-					colliding_entities.insert(e.get_id());
-					colliding_entities.insert(other.get_id());
+				swept.push_back({ start_x, start_y, w, h, x - start_x, y - start_y });
+
+				if (collider.is_continuous) {
+					x1 = std::min(x, start_x);
+					y1 = std::min(y, start_y);
+					w += std::abs(x - start_x);
+					h += std::abs(y - start_y);
 				}
 			}
+			else {
+				swept.push_back({ x, y, w, h, 0.0, 0.0 });
+			}
+
+			continuous.push_back(collider.is_continuous);
+			dynamic.push_back(is_dynamic);
+
+			unsorted_bounds.push_back(
+				static_cast<float>(static_cast<int>(x1)),
+				static_cast<float>(static_cast<int>(y1)),
+				static_cast<float>(static_cast<int>(x1 + w)),
+				static_cast<float>(static_cast<int>(y1 + h))
+			);
+		}
+	}
+
+	void sort_bounds() {
+		order.resize(unsorted_bounds.size());
+		for (std::size_t i{}; i < order.size(); ++i) {
+			order[i] = static_cast<std::uint32_t>(i);
+		}
 
-			if (colliding_entities.contains(e.get_id())) {
-				collider.is_colliding = true;
+		std::sort(
+			order.begin(),
+			order.end(),
+			[this](std::uint32_t a, std::uint32_t b) -> bool {
+				float a_x{ unsorted_bounds.min_x[a] };
+				float b_x{ unsorted_bounds.min_x[b] };
+				return a_x < b_x || (a_x == b_x && a < b);
 			}
-			else {
-				collider.is_colliding = false;
+		);
+
+		auto& entities{ get_entities() };
+
+		bounds.clear();
+		bounds.reserve(order.size());
+		sorted_entities.clear();
+		max_width = 0.0f;
+
+		for (std::uint32_t i : order) {
+			bounds.push_back(
+				unsorted_bounds.min_x[i],
+				unsorted_bounds.min_y[i],
+				unsorted_bounds.max_x[i],
+				unsorted_bounds.max_y[i]
+			);
+			sorted_entities.push_back(entities[i]);
+			max_width = std::max(max_width, unsorted_bounds.max_x[i] - unsorted_bounds.min_x[i]);
+		}
+	}
+
+	// Fills query_hits with the sorted indices of the colliders overlapping the box.
+	// Only colliders starting less than max_width before x1 can reach into it.
+	void find_candidates(double x1, double y1, double x2, double y2) {
+		query_hits.clear();
+
+		auto first{ std::upper_bound(bounds.min_x.begin(), bounds.min_x.end(), static_cast<float>(x1) - max_width) };
+		auto last{ std::lower_bound(first, bounds.min_x.end(), static_cast<float>(x2)) };
+
+		aabb_kernel::overlap(
+			bounds,
+			static_cast<float>(x1),
+			static_cast<float>(y1),
+			static_cast<float>(x2),
+			static_cast<float>(y2),
+			static_cast<std::size_t>(first - bounds.min_x.begin()),
+			static_cast<std::size_t>(last - bounds.min_x.begin()),
+			query_hits
+		);
+	}
+
+	// Slab test of one axis, narrows [entry, exit] to the part of the ray inside [min, max].
+	static bool clip_ray(double origin, double direction, float min_bound, float max_bound, double& entry, double& exit) {
+		if (direction == 0.0) {
+			return origin >= min_bound && origin <= max_bound;
+		}
+
+		double t1{ (min_bound - origin) / direction };
+		double t2{ (max_bound - origin) / direction };
+
+		entry = std::max(entry, std::min(t1, t2));
+		exit = std::min(exit, std::max(t1, t2));
+
+		return entry <= exit;
+	}
+
+	// TileCollisionEvent is only emitted on the frame a collider starts touching solid tiles.
+	// Colliders are split in slices like the pair search, every slice produces its events
+	// through its own lane of the channel, drained in slice order on dispatch.
+	void collide_with_tiles(std::vector<Entity>& entities, EventManager& event_manager, ThreadPool& thread_pool, const Tilemap& tilemap) {
+		const std::size_t count{ entities.size() };
+		const std::size_t slices{ count < min_parallel_colliders ? 1 : thread_pool.size() };
+
+		// A slice emits at most one event per collider, so a lane never fills up
+		auto& channel{ event_manager.open_channel<TileCollisionEvent>(slices, (count + slices - 1) / slices) };
+
+		for (const Entity& entity : entities) {
+			std::size_t id{ static_cast<std::size_t>(entity.get_id()) };
+			if (id >= touching_tiles.size()) {
+				touching_tiles.resize(id + 1, 0);
+			}
+		}
+
+		thread_pool.run(slices, [this, &entities, &channel, &tilemap, count, slices](std::size_t slice) {
+			const std::size_t first{ count * slice / slices };
+			const std::size_t last{ count * (slice + 1) / slices };
+
+			for (std::size_t i{ first }; i < last; ++i) {
+				collide_with_tiles(entities[i], i, channel, slice, tilemap);
+			}
+		});
+
+		// Forget destroyed entities so a recycled id starts untouched
+		for (std::size_t id{}; id < touching_tiles.size(); ++id) {
+			if (find_index(static_cast<int>(id)) < 0) {
+				touching_tiles[id] = 0;
 			}
 		}
 	}
 
-private:
-	bool check_collision(
-		const TransformComponent& a_transform,
-		const BoxColliderComponent& a_collider,
-		const TransformComponent& b_transform,
-		const BoxColliderComponent& b_collider
-	) {
+	void find_pairs(ThreadPool& thread_pool) {
+		const std::size_t count{ bounds.size() };
+		const std::size_t slices{ count < min_parallel_colliders ? 1 : thread_pool.size() };
+
+		buffers.resize(slices);
+
+		thread_pool.run(slices, [this, count, slices](std::size_t slice) {
+			PairBuffer& buffer{ buffers[slice] };
+			buffer.pairs.clear();
+
+			const std::size_t first{ count * slice / slices };
+			const std::size_t last{ count * (slice + 1) / slices };
+
+			for (std::size_t i{ first }; i < last; ++i) {
+				find_pairs(i, buffer);
+			}
+		});
+	}
+
+	void collide_with_tiles(const Entity& entity, std::size_t i, EventChannel<TileCollisionEvent>& channel, std::size_t slice, const Tilemap& tilemap) {
+		std::size_t id{ static_cast<std::size_t>(entity.get_id()) };
+
+		if (!dynamic[i]) {
+			touching_tiles[id] = 0;
+			return;
+		}
 
-		int a_x1{ static_cast<int>(a_transform.position.x + a_collider.offset.x) };
-		int a_x2{ static_cast<int>(a_transform.position.x + a_collider.offset.x + a_collider.width) };
-		int a_y1{ static_cast<int>(a_transform.position.y + a_collider.offset.y) };
-		int a_y2{ static_cast<int>(a_transform.position.y + a_collider.offset.y + a_collider.height) };
+		const SweptBox& box{ swept[i] };
+		double x{ box.x + box.dx };
+		double y{ box.y + box.dy };
 
-		int b_x1{ static_cast<int>(b_transform.position.x + b_collider.offset.x) };
-		int b_x2{ static_cast<int>(b_transform.position.x + b_collider.offset.x + b_collider.width) };
-		int b_y1{ static_cast<int>(b_transform.position.y + b_collider.offset.y) };
-		int b_y2{ static_cast<int>(b_transform.position.y + b_collider.offset.y + b_collider.height) };
+		int col{};
+		int row{};
+		bool is_touching{ tilemap.overlaps_solid(x, y, x + box.width, y + box.height, col, row) };
 
-		bool x_collision = a_x1 < b_x2 && a_x2 > b_x1;
-		bool y_collision = a_y1 < b_y2 && a_y2 > b_y1;
+		if (is_touching) {
+			colliding[i] = 1;
+
+			if (!touching_tiles[id]) {
+				// Lanes hold a whole slice, see collide_with_tiles above
+				[[maybe_unused]] const bool pushed{ channel.try_push(slice, entity, col, row) };
+				assert(pushed && "TileCollisionEvent lane full");
+			}
+		}
+
+		touching_tiles[id] = is_touching;
+	}
+
+	// Appends the confirmed contacts between collider i (in sorted order) and the ones after it.
+	void find_pairs(std::size_t i, PairBuffer& buffer) const {
+		auto first{ bounds.min_x.begin() + static_cast<std::ptrdiff_t>(i + 1) };
+		auto last{ std::lower_bound(first, bounds.min_x.end(), bounds.max_x[i]) };
+
+		buffer.hits.clear();
+		aabb_kernel::overlap(
+			bounds,
+			i,
+			i + 1,
+			static_cast<std::size_t>(last - bounds.min_x.begin()),
+			buffer.hits
+		);
+
+		for (std::uint32_t j : buffer.hits) {
+			std::uint32_t a{ order[i] };
+			std::uint32_t b{ order[j] };
+
+			if (a > b) {
+				std::swap(a, b);
+			}
+
+			if ((continuous[a] || continuous[b]) && !sweep_test(a, b)) {
+				continue;
+			}
+
+			buffer.pairs.emplace_back(a, b);
+		}
+	}
 
-		return x_collision && y_collision;
+	// Swept boxes aren't truncated, the time of impact is computed on exact positions.
+	bool sweep_test(std::uint32_t a, std::uint32_t b) const {
+		double time_of_impact{};
+		return swept_aabb::intersect(swept[a], swept[b], time_of_impact);
 	}
 };
 
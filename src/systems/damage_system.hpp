@@ -2,47 +2,53 @@
 #define DAMAGE_SYSTEM_HPP
 
 #include "../ecs/ecs.hpp"
+#include "../collision/contact_pair.hpp"
 #include "../components/box_collider_component.hpp"
 #include "../components/projectile_component.hpp"
 #include "../components/health_component.hpp"
-#include "../event_manager/event_manager.hpp"
-#include "../events/collision_event.hpp"
 #include "../logger/logger.hpp"
 
+#include <span>
+
 class DamageSystem : public System {
 public:
 	DamageSystem() {
 		require_component<BoxColliderComponent>();
 	}
 
-	void listen_to_event(EventManager& event_manager) {
-		event_manager.listen<DamageSystem, CollisionEvent>(this, &DamageSystem::on_collision);
-	}
-
-	void on_collision(CollisionEvent& event) {
-		Logger::log("Collision " + std::to_string(event.a.get_id()) + " and " + std::to_string(event.b.get_id()));
+	// Consumes the contact stream of the CollisionSystem, only new contacts deal damage.
+	void update(std::span<const ContactPair> contacts, Registry& registry) {
+		const int projectiles{ registry.intern_group("projectiles") };
+		const int enemies{ registry.intern_group("enemies") };
 
-		Entity& a{ event.a };
-		Entity& b{ event.b };
-
-		if (a.belong_to_group("projectiles") && b.has_tag("player")) {
-			projectile_damage(a, b);
-		}
-		else if (b.belong_to_group("projectiles") && a.has_tag("player")) {
-			projectile_damage(b, a);
+		// The player has no group, so its contacts are in the ungrouped range
+		for (const ContactPair& contact : contact_pair::between(contacts, projectiles, -1)) {
+			if (contact.is_new) {
+				const Entity& player{ contact.a_group == projectiles ? contact.b : contact.a };
+				const Entity& projectile{ contact.a_group == projectiles ? contact.a : contact.b };
+				if (player.has_tag("player")) {
+					log_contact(contact);
+					projectile_damage(projectile, player);
+				}
+			}
 		}
-		else if (a.belong_to_group("projectiles") && b.belong_to_group("enemies")) {
-			projectile_damage(a, b);
-		}
-		else if (b.belong_to_group("projectiles") && a.belong_to_group("enemies")) {
-			projectile_damage(b, a);
+
+		for (const ContactPair& contact : contact_pair::between(contacts, projectiles, enemies)) {
+			if (contact.is_new) {
+				const Entity& enemy{ contact.a_group == projectiles ? contact.b : contact.a };
+				const Entity& projectile{ contact.a_group == projectiles ? contact.a : contact.b };
+				log_contact(contact);
+				projectile_damage(projectile, enemy);
+			}
 		}
 	}
 
-	void update() {}
-
 private:
-	void projectile_damage(Entity& projectile, Entity entity) {
+	void log_contact(const ContactPair& contact) {
+		Logger::log("Collision " + std::to_string(contact.a.get_id()) + " and " + std::to_string(contact.b.get_id()));
+	}
+
+	void projectile_damage(Entity projectile, Entity entity) {
 		auto& p{ projectile.get_component<ProjectileComponent>() };
 		auto& h{ entity.get_component<HealthComponent>() };
 
@@ -0,0 +1,25 @@
+#ifndef INTERPOLATION_SYSTEM_HPP
+#define INTERPOLATION_SYSTEM_HPP
+
+#include "../ecs/ecs.hpp"
+#include "../components/transform_component.hpp"
+
+/*
+* Runs first in every simulation step: whatever moves an entity during the step
+* (integration, contacts, scripts) is then drawn interpolated from where it started.
+*/
+class InterpolationSystem : public System {
+public:
+	InterpolationSystem() {
+		require_component<TransformComponent>();
+	}
+
+	void update() {
+		for (const Entity& entity : get_entities()) {
+			TransformComponent& transform{ entity.get_component<TransformComponent>() };
+			transform.render_previous_position = transform.position;
+		}
+	}
+};
+
+#endif //INTERPOLATION_SYSTEM_HPP
@@ -4,6 +4,8 @@
 #include "../ecs/ecs.hpp"
 #include "../event_manager/event_manager.hpp"
 #include "../events/key_pressed_event.hpp"
+#include "../components/animation_component.hpp"
+#include "../components/box_collider_component.hpp"
 #include "../components/keyboard_control_component.hpp"
 #include "../components/sprite_component.hpp"
 #include "../components/rigidbody_component.hpp"
@@ -25,10 +27,7 @@ public:
 	}
 
 	void listen_to_event(EventManager& event_manager) {
-		event_manager.listen<KeyboarControlSystem, KeyPressedEvent>(
-			this,
-			&KeyboarControlSystem::on_key_press
-		);
+		key_pressed_subscription = event_manager.listen<&KeyboarControlSystem::on_key_press>(this);
 	}
 
 	void on_key_press(KeyPressedEvent& event) {
@@ -39,8 +38,11 @@ public:
 	void update() {}
 
 private:
+	EventSubscription key_pressed_subscription{};
+
 	void player_movement(KeyPressedEvent& event);
 	void player_fire(KeyPressedEvent& event);
+	void face(Entity& entity, SpriteComponent& sprite, AnimationClipHandle clip, int row);
 };
 
 inline void KeyboarControlSystem::player_movement(KeyPressedEvent& event) {
@@ -53,22 +55,22 @@ inline void KeyboarControlSystem::player_movement(KeyPressedEvent& event) {
 		{
 		case SDLK_UP:
 			rigidbody.velocity = keyboard_control.up_velocity;
-			sprite.src_rect.y = 0 * sprite.height;
+			face(entity, sprite, keyboard_control.up_clip, 0);
 			break;
 
 		case SDLK_RIGHT:
 			rigidbody.velocity = keyboard_control.right_velocity;
-			sprite.src_rect.y = 1 * sprite.height;
+			face(entity, sprite, keyboard_control.right_clip, 1);
 			break;
 
 		case SDLK_DOWN:
 			rigidbody.velocity = keyboard_control.down_velocity;
-			sprite.src_rect.y = 2 * sprite.height;
+			face(entity, sprite, keyboard_control.down_clip, 2);
 			break;
 
 		case SDLK_LEFT:
 			rigidbody.velocity = keyboard_control.left_velocity;
-			sprite.src_rect.y = 3 * sprite.height;
+			face(entity, sprite, keyboard_control.left_clip, 3);
 			break;
 
 		default:
@@ -77,6 +79,15 @@ inline void KeyboarControlSystem::player_movement(KeyPressedEvent& event) {
 	}
 }
 
+inline void KeyboarControlSystem::face(Entity& entity, SpriteComponent& sprite, AnimationClipHandle clip, int row) {
+	if (clip.is_valid() && entity.has_component<AnimationComponent>()) {
+		entity.get_component<AnimationComponent>().play(clip);
+	}
+	else {
+		sprite.src_rect.y = row * sprite.height;
+	}
+}
+
 inline void KeyboarControlSystem::player_fire(KeyPressedEvent& event) {
 	if (!(event.key == SDLK_SPACE)) {
 		return;
@@ -117,8 +128,8 @@ inline void KeyboarControlSystem::player_fire(KeyPressedEvent& event) {
 		projectile.add_group("projectiles");
 		projectile.add_component<TransformComponent>(projectile_pos);
 		projectile.add_component<RigidbodyComponent>(emitter.velocity * direction);
-		projectile.add_component<SpriteComponent>("bullet-texture", 3, false, 4, 4);
-		projectile.add_component<BoxColliderComponent>(4, 4);
+		projectile.add_component<SpriteComponent>(emitter.projectile_texture, 3, false, 4, 4);
+		projectile.add_component<BoxColliderComponent>(4, 4, glm::dvec2(0.0), true);
 		projectile.add_component<ProjectileComponent>(
 			emitter.damage,
 			emitter.duration,
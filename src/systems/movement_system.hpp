@@ -3,12 +3,15 @@
 
 #include "../game/game.hpp"
 #include "../ecs/ecs.hpp"
+#include "../collision/contact_pair.hpp"
 #include "../event_manager/event_manager.hpp"
-#include "../events/collision_event.hpp"
+#include "../events/tile_collision_event.hpp"
 #include "../components/transform_component.hpp"
 #include "../components/rigidbody_component.hpp"
 #include "../components/sprite_component.hpp"
 
+#include <span>
+
 class MovementSystem : public System {
 public:
 	MovementSystem() {
@@ -16,29 +19,46 @@ public:
 		require_component<RigidbodyComponent>();
 	}
 
-	void listen_to_event(EventManager& event_manager) {
-		event_manager.listen<MovementSystem, CollisionEvent>(this, &MovementSystem::on_collision);
+	// Scoped subscriptions, the event manager only calls them for their own group
+	void listen_to_event(EventManager& event_manager, Registry& registry) {
+		enemy_tile_subscription = event_manager.listen<&MovementSystem::on_enemy_tile_collision>(
+			this,
+			EventScope::group(registry.intern_group("enemies"))
+		);
+		projectile_tile_subscription = event_manager.listen<&MovementSystem::on_projectile_tile_collision>(
+			this,
+			EventScope::group(registry.intern_group("projectiles"))
+		);
 	}
 
-	void on_collision(CollisionEvent& event) {
-		Logger::log("Collision " + std::to_string(event.a.get_id()) + " and " + std::to_string(event.b.get_id()));
-
-		Entity& a{ event.a };
-		Entity& b{ event.b };
+	// Consumes the contact stream of the CollisionSystem, enemies turn around when they hit an obstacle.
+	void on_contacts(std::span<const ContactPair> contacts, Registry& registry) {
+		const int enemies{ registry.intern_group("enemies") };
+		const int obstacles{ registry.intern_group("obstacles") };
 
-		if (a.belong_to_group("enemies") && b.belong_to_group("obstacles")) {
-			move_opposite_direction(a, b);
-		}
-		else if (b.belong_to_group("enemies") && a.belong_to_group("obstacles")) {
-			move_opposite_direction(b, a);
+		for (const ContactPair& contact : contact_pair::between(contacts, enemies, obstacles)) {
+			if (contact.is_new) {
+				Entity enemy{ contact.a_group == enemies ? contact.a : contact.b };
+				move_opposite_direction(enemy);
+			}
 		}
 	}
 
+	void on_enemy_tile_collision(TileCollisionEvent& event) {
+		move_opposite_direction(event.entity);
+	}
+
+	void on_projectile_tile_collision(TileCollisionEvent& event) {
+		event.entity.free();
+	}
+
 	void update(double delta_time) {
 		for (Entity& entity : get_entities()) {
 			TransformComponent& transform{ entity.get_component<TransformComponent>() };
 			RigidbodyComponent& rigidbody{ entity.get_component<RigidbodyComponent>() };
 
+			transform.previous_position = transform.position;
+
 			transform.position.x += rigidbody.velocity.x * delta_time;
 			transform.position.y += rigidbody.velocity.y * delta_time;
 
@@ -67,8 +87,10 @@ public:
 	}
 
 private:
-	void move_opposite_direction(Entity& enemy, Entity& obstacle) {
-		(void)obstacle;
+	EventSubscription enemy_tile_subscription{};
+	EventSubscription projectile_tile_subscription{};
+
+	void move_opposite_direction(Entity& enemy) {
 		if (!enemy.has_component<RigidbodyComponent>() ||
 			!enemy.has_component<SpriteComponent>()) {
 			return;
@@ -0,0 +1,196 @@
+#ifndef PARTICLE_SYSTEM_HPP
+#define PARTICLE_SYSTEM_HPP
+
+#include "../asset_manager/asset_manager.hpp"
+#include "../ecs/ecs.hpp"
+#include "../components/particle_emitter_component.hpp"
+#include "../components/transform_component.hpp"
+#include "../particles/particle_buffer.hpp"
+#include "../particles/particle_kernel.hpp"
+#include "../renderer/render_snapshot.hpp"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ParticleSystem : public System {
+public:
+	static constexpr std::size_t max_particles{ 100000 };
+
+	ParticleSystem() {
+		require_component<TransformComponent>();
+		require_component<ParticleEmitterComponent>();
+
+		particles.reserve(max_particles);
+	}
+
+	// Ages and moves the live particles, then lets the emitters spawn new ones.
+	// Particles outlive their emitter.
+	void update(double delta_time) {
+		particle_kernel::update(particles, static_cast<float>(delta_time));
+
+		for (const Entity& entity : get_entities()) {
+			auto& emitter{ entity.get_component<ParticleEmitterComponent>() };
+			const auto& transform{ entity.get_component<TransformComponent>() };
+
+			emit(emitter, transform, delta_time);
+		}
+	}
+
+	// Records a quad per visible particle. Particles are drawn 'step' seconds behind
+	// (at most their age), scaled by 1 - alpha, matching the interpolation of the entities.
+	void render(AssetManager& asset_manager, RenderSnapshot& snapshot, SDL_Rect* camera, double alpha, double step) {
+		style_regions.clear();
+		for (const Style& style : styles) {
+			style_regions.push_back(&asset_manager.get_region(style.texture));
+		}
+
+		const float behind{ static_cast<float>(step * (1.0 - alpha)) };
+		const float camera_x1{ static_cast<float>(camera->x) };
+		const float camera_y1{ static_cast<float>(camera->y) };
+		const float camera_x2{ static_cast<float>(camera->x + camera->w) };
+		const float camera_y2{ static_cast<float>(camera->y + camera->h) };
+
+		for (std::size_t i{}; i < particles.size(); ++i) {
+			const Style& style{ styles[particles.style[i]] };
+			const TextureRegion& region{ *style_regions[particles.style[i]] };
+
+			const float back{ std::min(behind, particles.age[i]) };
+			const float x{ particles.x[i] - particles.velocity_x[i] * back };
+			const float y{ particles.y[i] - particles.velocity_y[i] * back };
+
+			if (x + style.width < camera_x1 || x > camera_x2 || y + style.height < camera_y1 || y > camera_y2) {
+				continue;
+			}
+
+			const int frame{ static_cast<int>(particles.age[i] * style.frame_rate) % style.frames };
+
+			const SDL_Rect src_rect{
+				region.rect.x + frame * style.frame_width,
+				region.rect.y,
+				style.frame_width,
+				style.frame_height
+			};
+
+			snapshot.draw(
+				region.texture,
+				src_rect,
+				{ std::round(x - camera_x1), std::round(y - camera_y1), style.width, style.height }
+			);
+		}
+	}
+
+	std::size_t get_particle_count() const { return particles.size(); }
+
+private:
+	// Everything particles of one look share, emitters with the same settings share a style
+	struct Style {
+		TextureHandle texture{};
+		int frame_width{};
+		int frame_height{};
+		int frames{};
+		float frame_rate{};
+		float width{};
+		float height{};
+	};
+
+	ParticleBuffer particles{};
+	std::vector<Style> styles{};
+	std::vector<const TextureRegion*> style_regions{};
+
+	// Fixed seed, so headless runs and replays draw the same particles
+	std::uint32_t random_state{ 0x9E3779B9u };
+
+	// Uniform in [-range, range]
+	float random(float range) {
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 17;
+		random_state ^= random_state << 5;
+
+		return (static_cast<float>(random_state) / 4294967295.0f * 2.0f - 1.0f) * range;
+	}
+
+	std::uint16_t get_style(ParticleEmitterComponent& emitter) {
+		if (emitter.style >= 0) {
+			return static_cast<std::uint16_t>(emitter.style);
+		}
+
+		const Style style{
+			emitter.texture,
+			emitter.frame_width,
+			emitter.frame_height,
+			std::max(emitter.frames, 1),
+			static_cast<float>(emitter.frame_rate),
+			static_cast<float>(emitter.frame_width * emitter.scale),
+			static_cast<float>(emitter.frame_height * emitter.scale)
+		};
+
+		auto same_style = [&style](const Style& other) {
+			return other.texture.index == style.texture.index &&
+				other.frame_width == style.frame_width &&
+				other.frame_height == style.frame_height &&
+				other.frames == style.frames &&
+				other.frame_rate == style.frame_rate &&
+				other.width == style.width &&
+				other.height == style.height;
+		};
+
+		auto it{ std::find_if(styles.begin(), styles.end(), same_style) };
+		if (it == styles.end()) {
+			styles.push_back(style);
+			it = styles.end() - 1;
+		}
+
+		emitter.style = static_cast<int>(it - styles.begin());
+		return static_cast<std::uint16_t>(emitter.style);
+	}
+
+	void emit(ParticleEmitterComponent& emitter, const TransformComponent& transform, double delta_time) {
+		if (emitter.duration >= 0.0 && emitter.elapsed_seconds >= emitter.duration) {
+			return;
+		}
+
+		int count{};
+
+		if (!emitter.has_burst) {
+			emitter.has_burst = true;
+			count += emitter.burst;
+		}
+
+		emitter.elapsed_seconds += delta_time;
+		emitter.pending_particles += emitter.rate * delta_time;
+
+		const int pending{ static_cast<int>(emitter.pending_particles) };
+		emitter.pending_particles -= pending;
+		count += pending;
+
+		const std::uint16_t style{ get_style(emitter) };
+
+		const float x{ static_cast<float>(transform.position.x + emitter.offset.x) };
+		const float y{ static_cast<float>(transform.position.y + emitter.offset.y) };
+		const float spread{ static_cast<float>(emitter.spread) };
+		const float jitter{ static_cast<float>(emitter.lifetime_jitter) };
+
+		for (int i{}; i < count && particles.size() < max_particles; ++i) {
+			const float lifetime{ static_cast<float>(emitter.lifetime) + random(jitter) };
+			if (lifetime <= 0.0f) {
+				continue;
+			}
+
+			particles.push_back(
+				x,
+				y,
+				static_cast<float>(emitter.velocity.x) + random(spread),
+				static_cast<float>(emitter.velocity.y) + random(spread),
+				lifetime,
+				style
+			);
+		}
+	}
+};
+
+#endif //PARTICLE_SYSTEM_HPP
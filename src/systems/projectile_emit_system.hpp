@@ -49,8 +49,8 @@ public:
 				projectile.add_group("projectiles");
 				projectile.add_component<TransformComponent>(projectile_pos);
 				projectile.add_component<RigidbodyComponent>(emitter.velocity);
-				projectile.add_component<SpriteComponent>("bullet-texture", 3, false, 4, 4);
-				projectile.add_component<BoxColliderComponent>(4, 4);
+				projectile.add_component<SpriteComponent>(emitter.projectile_texture, 3, false, 4, 4);
+				projectile.add_component<BoxColliderComponent>(4, 4, glm::dvec2(0.0), true);
 				projectile.add_component<ProjectileComponent>(
 					emitter.damage,
 					emitter.duration,
@@ -5,8 +5,10 @@
 #include "../ecs/ecs.hpp"
 #include "../components/transform_component.hpp"
 #include "../components/box_collider_component.hpp"
+#include "../renderer/render_snapshot.hpp"
 
 #include <SDL2/SDL.h>
+#include <glm/glm.hpp>
 
 class RenderCollisionSystem : public System {
 public:
@@ -15,28 +17,30 @@ public:
 		require_component<BoxColliderComponent>();
 	}
 
-	void update(SDL_Renderer* renderer, SDL_Rect* camera) {
+	// Outlines are drawn at the interpolated position, like the sprites they belong to.
+	void update(RenderSnapshot& snapshot, double alpha) {
+
+		DebugDraw& debug_draw{ snapshot.debug_draw() };
 
 		for (const Entity& e : get_entities()) {
 			const TransformComponent& transform{ e.get_component<TransformComponent>() };
 			const BoxColliderComponent& collider{ e.get_component<BoxColliderComponent>() };
 
+			const glm::dvec2 position{ transform.interpolate(alpha) };
+
 			SDL_Rect collider_rect{
-				static_cast<int>(transform.position.x + collider.offset.x) - static_cast<int>(camera->x),
-				static_cast<int>(transform.position.y + collider.offset.y) -
-				static_cast<int>(camera->y),
+				static_cast<int>(position.x + collider.offset.x),
+				static_cast<int>(position.y + collider.offset.y),
 				collider.width,
 				collider.height
 			};
 
 			if (collider.is_colliding) {
-				SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+				debug_draw.rect(collider_rect, { 255, 0, 0, 255 });
 			}
 			else {
-				SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
+				debug_draw.rect(collider_rect, { 255, 255, 0, 255 });
 			}
-
-			SDL_RenderDrawRect(renderer, &collider_rect);
 		}
 	}
 };
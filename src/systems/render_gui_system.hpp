@@ -1,6 +1,7 @@
 #ifndef RENDER_GUI_SYSTEM_HPP
 #define RENDER_GUI_SYSTEM_HPP
 
+#include "../asset_manager/asset_manager.hpp"
 #include "../ecs/ecs.hpp"
 
 #include "../components/animation_component.hpp"
@@ -22,7 +23,7 @@ class RenderGuiSystem : public System {
 public:
 	RenderGuiSystem() = default;
 
-	void update(SDL_Renderer* renderer, Registry& registry, SDL_Rect& camera) {
+	void update(SDL_Renderer* renderer, Registry& registry, AssetManager& asset_manager, SDL_Rect& camera) {
 		//Dear ImGui setup
 		ImGui_ImplSDLRenderer2_NewFrame();
 		ImGui_ImplSDL2_NewFrame();
@@ -97,7 +98,7 @@ public:
 					glm::degrees(rotation)
 				);
 				enemy.add_component<RigidbodyComponent>(glm::dvec2(vel_x, vel_y));
-				enemy.add_component<SpriteComponent>(sprites[selected_sprite_index], 1);
+				enemy.add_component<SpriteComponent>(asset_manager.get_texture_handle(sprites[selected_sprite_index]), 1);
 				enemy.add_component<BoxColliderComponent>(25, 20, glm::dvec2(5.0, 5.0));
 
 				double proj_vel_x{ cos(proj_angle) * proj_speed };
@@ -107,7 +108,9 @@ public:
 					glm::dvec2{ proj_vel_x, proj_vel_y },
 					proj_dmg,
 					static_cast<double>(proj_delay),
-					static_cast<double>(proj_duration)
+					static_cast<double>(proj_duration),
+					false,
+					asset_manager.get_texture_handle("bullet-texture")
 				);
 				enemy.add_component<HealthComponent>(health);
 
@@ -7,8 +7,9 @@
 #include "../components/transform_component.hpp"
 #include "../components/sprite_component.hpp"
 
+#include "../renderer/render_snapshot.hpp"
+
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
 
 class RenderHealthSystem : public System {
 
@@ -19,75 +20,93 @@ public:
 		require_component<SpriteComponent>();
 	}
 
-	void update(SDL_Renderer* renderer, AssetManager& asset_manager, SDL_Rect* camera) {
+	void update(AssetManager& asset_manager, RenderSnapshot& snapshot, SDL_Rect* camera, double alpha) {
+
+		// Resolved once, the handle stays valid for as long as the level's assets are loaded
+		if (!font.is_valid()) {
+			font = asset_manager.get_font_handle("pico8-font-5");
+		}
+
+		const GlyphAtlas* glyph_atlas{ asset_manager.get_glyph_atlas(font) };
+
+		// All the bars first, then all the numbers, so each kind is a single run of the snapshot
+		DebugDraw& debug_draw{ snapshot.debug_draw() };
 
 		for (const Entity e : get_entities()) {
-			auto& health{ e.get_component<HealthComponent>() };
-			auto& transform{ e.get_component<TransformComponent>() };
-			auto& sprite{ e.get_component<SpriteComponent>() };
+			const HealthBar bar{ make_health_bar(e, alpha) };
+			debug_draw.fill_rect(bar.rect, { bar.color.r, bar.color.g, bar.color.b, 255 });
+		}
 
-			SDL_Color health_bar_color{ 255, 255, 255, 0 };
+		if (glyph_atlas == nullptr) {
+			return;
+		}
 
-			int health_amount{ health.health };
+		for (const Entity e : get_entities()) {
+			const HealthBar bar{ make_health_bar(e, alpha) };
 
-			if (health_amount >= 80) {
-				health_bar_color = { 0, 255, 0, 0 };
-			}
-			else if (health_amount >= 40) {
-				health_bar_color = { 255, 255, 0, 0 };
-			}
-			else {
-				health_bar_color = { 255, 0, 0, 0 };
+			// The number sits above the bar and is at most a few glyphs wide
+			const int x{ bar.rect.x - camera->x };
+			const int y{ bar.rect.y - 6 - camera->y };
+
+			if (x + text_max_width < 0 || x > camera->w || y + glyph_atlas->get_line_height() < 0 || y > camera->h) {
+				continue;
 			}
 
-			int health_bar_width{ 15 };
-			int health_bar_height{ 3 };
-			double health_bar_pos_x{ (transform.position.x + (sprite.width / 3 * transform.scale.x)) - camera->x };
-			double health_bar_pos_y{ transform.position.y - camera->y };
-
-			SDL_Rect health_bar_rect{
-				static_cast<int>(health_bar_pos_x),
-				static_cast<int>(health_bar_pos_y),
-				static_cast<int>(health_bar_width * (health_amount / 100.0)),
-				static_cast<int>(health_bar_height)
-			};
-
-			SDL_SetRenderDrawColor(
-				renderer,
-				health_bar_color.r,
-				health_bar_color.g,
-				health_bar_color.b,
-				255
+			glyph_atlas->draw(
+				snapshot,
+				std::to_string(bar.health),
+				static_cast<float>(x),
+				static_cast<float>(y),
+				{ bar.color.r, bar.color.g, bar.color.b, 255 }
 			);
+		}
+	}
 
-			SDL_RenderFillRect(renderer, &health_bar_rect);
-
-			std::string health_text{ std::to_string(health_amount) };
-			SDL_Surface* surface{
-				TTF_RenderText_Blended(
-					asset_manager.get_font("pico8-font-5"),
-					health_text.c_str(),
-					health_bar_color
-				)
-			};
-
-			SDL_Texture* texture{ SDL_CreateTextureFromSurface(renderer, surface) };
-			SDL_FreeSurface(surface);
-
-			int label_w{ 0 };
-			int label_h{ 0 };
-			SDL_QueryTexture(texture, NULL, NULL, &label_w, &label_h);
-			SDL_Rect health_bar_text_rect{
-				static_cast<int>(health_bar_pos_x),
-				static_cast<int>(health_bar_pos_y) - 6,
-				label_w,
-				label_h
-			};
-
-			SDL_RenderCopy(renderer, texture, NULL, &health_bar_text_rect);
-
-			SDL_DestroyTexture(texture);
+private:
+	static constexpr int text_max_width{ 32 };
+
+	FontHandle font{};
+
+	struct HealthBar {
+		SDL_Rect rect{}; // world space
+		SDL_Color color{};
+		int health{};
+	};
+
+	static HealthBar make_health_bar(const Entity& e, double alpha) {
+		auto& health{ e.get_component<HealthComponent>() };
+		auto& transform{ e.get_component<TransformComponent>() };
+		auto& sprite{ e.get_component<SpriteComponent>() };
+
+		SDL_Color health_bar_color{ 255, 255, 255, 0 };
+
+		int health_amount{ health.health };
+
+		if (health_amount >= 80) {
+			health_bar_color = { 0, 255, 0, 0 };
 		}
+		else if (health_amount >= 40) {
+			health_bar_color = { 255, 255, 0, 0 };
+		}
+		else {
+			health_bar_color = { 255, 0, 0, 0 };
+		}
+
+		int health_bar_width{ 15 };
+		int health_bar_height{ 3 };
+		const glm::dvec2 position{ transform.interpolate(alpha) };
+
+		double health_bar_pos_x{ position.x + (sprite.width / 3 * transform.scale.x) };
+		double health_bar_pos_y{ position.y };
+
+		SDL_Rect health_bar_rect{
+			static_cast<int>(health_bar_pos_x),
+			static_cast<int>(health_bar_pos_y),
+			static_cast<int>(health_bar_width * (health_amount / 100.0)),
+			static_cast<int>(health_bar_height)
+		};
+
+		return { health_bar_rect, health_bar_color, health_amount };
 	}
 };
 
@@ -2,17 +2,19 @@
 #define RENDER_SYSTEM_HPP
 
 #include "../ecs/ecs.hpp"
+#include "../asset_manager/asset_manager.hpp"
 #include "../components/transform_component.hpp"
 #include "../components/sprite_component.hpp"
 
 #include "../components/rigidbody_component.hpp"
+#include "../renderer/radix_sort.hpp"
+#include "../renderer/render_snapshot.hpp"
 
 #include <SDL2/SDL.h>
 
 #include <vector>
 #include <algorithm>
-
-#include <iostream>
+#include <cstdint>
 
 class RenderSystem : public System {
 public:
@@ -21,64 +23,125 @@ public:
 		require_component<SpriteComponent>();
 	}
 
-	void update(SDL_Renderer* renderer, AssetManager& asset_manager, SDL_Rect* camera) {
+	void update(AssetManager& asset_manager, RenderSnapshot& snapshot, SDL_Rect* camera, double alpha) {
 
-		std::vector<Entity> renderable_entities{};
+		if (render_version != get_entities_version()) {
+			build_render_list();
+		}
 
-		for (const Entity& entity : get_entities()) {
+		// Culling keeps the order of the render list, no sorting per frame
+		if (!cull(camera, alpha)) {
+			build_render_list();
+			cull(camera, alpha);
+		}
 
-			auto& transform{ entity.get_component<TransformComponent>() };
-			auto& sprite{ entity.get_component<SpriteComponent>() };
+		for (const Entity entity : visible_entities) {
+			const TransformComponent& transform{ entity.get_component<TransformComponent>() };
+			const SpriteComponent& sprite{ entity.get_component<SpriteComponent>() };
 
-			bool is_outside_camera_view{
-				(transform.position.x + sprite.width * transform.scale.x) < camera->x ||
-				transform.position.x > (camera->x + camera->w) ||
-				(transform.position.y + sprite.height * transform.scale.y) < camera->y ||
-				transform.position.y > (camera->y + camera->h)
+			const glm::dvec2 position{ transform.interpolate(alpha) };
+
+			int camera_x = sprite.is_fixed ? 0 : camera->x;
+			int camera_y = sprite.is_fixed ? 0 : camera->y;
+
+			const SDL_FRect dest_rect{
+				static_cast<float>(std::round(position.x - camera_x)),
+				static_cast<float>(std::round(position.y - camera_y)),
+				static_cast<float>(static_cast<int>(sprite.width * transform.scale.x)),
+				static_cast<float>(static_cast<int>(sprite.height * transform.scale.y))
 			};
 
-			if (is_outside_camera_view && !sprite.is_fixed) {
+			// Sprites keep source rectangles relative to their own image, offset into the atlas here
+			const TextureRegion& region{ asset_manager.get_region(sprite.texture) };
+			if (region.texture == nullptr) {
 				continue;
 			}
 
-			renderable_entities.push_back(entity);
+			const SDL_Rect src_rect{
+				region.rect.x + sprite.src_rect.x,
+				region.rect.y + sprite.src_rect.y,
+				sprite.src_rect.w,
+				sprite.src_rect.h
+			};
+
+			snapshot.draw(
+				region.texture,
+				src_rect,
+				dest_rect,
+				transform.rotation,
+				sprite.flip
+			);
 		}
+	}
 
-		std::sort(
-			renderable_entities.begin(),
-			renderable_entities.end(),
-			[](const Entity& e1, const Entity& e2) -> bool {
-				auto& e1_sprite{ e1.get_component<SpriteComponent>() };
-				auto& e2_sprite{ e2.get_component<SpriteComponent>() };
+private:
+	// Sorted by z_index, then texture so sprites sharing one are batched together
+	std::vector<std::uint64_t> render_keys{};
+	std::vector<std::uint64_t> sort_scratch{};
+	std::vector<Entity> render_list{};
+	std::vector<Entity> visible_entities{};
+	std::uint32_t render_version{};
 
-				return e1_sprite.z_index < e2_sprite.z_index;
-			}
-		);
+	static constexpr std::uint64_t index_mask{ 0xFFFFFFFF };
 
-		for (const Entity entity : renderable_entities) {
-			const TransformComponent& transform{ entity.get_component<TransformComponent>() };
-			const SpriteComponent& sprite{ entity.get_component<SpriteComponent>() };
+	// z_index (16 bits, biased) | texture handle (16 bits) | index of the entity in the system (32 bits)
+	static std::uint64_t make_key(const SpriteComponent& sprite, std::size_t index) {
+		const std::uint64_t z{ static_cast<std::uint64_t>(std::clamp(sprite.z_index, -0x8000, 0x7FFF) + 0x8000) };
+		const std::uint64_t texture{ static_cast<std::uint64_t>(sprite.texture.index + 1) & 0xFFFF };
 
-			int camera_x = sprite.is_fixed ? 0 : camera->x;
-			int camera_y = sprite.is_fixed ? 0 : camera->y;
+		return (z << 48) | (texture << 32) | (static_cast<std::uint64_t>(index) & index_mask);
+	}
 
-			const SDL_Rect dest_rect{
-				static_cast<int>(std::round(transform.position.x - camera_x)),
-				static_cast<int>(std::round(transform.position.y - camera_y)),
-				static_cast<int>(sprite.width * transform.scale.x),
-				static_cast<int>(sprite.height * transform.scale.y)
+	void build_render_list() {
+		const std::vector<Entity>& entities{ get_entities() };
+
+		render_keys.clear();
+		for (std::size_t i{}; i < entities.size(); ++i) {
+			render_keys.push_back(make_key(entities[i].get_component<SpriteComponent>(), i));
+		}
+
+		radix_sort(render_keys, sort_scratch);
+
+		render_list.clear();
+		for (const std::uint64_t key : render_keys) {
+			render_list.push_back(entities[static_cast<std::size_t>(key & index_mask)]);
+		}
+
+		render_version = get_entities_version();
+	}
+
+	// Fills visible_entities in render order.
+	// Returns false if a sprite changed layer or texture since the list was built.
+	bool cull(const SDL_Rect* camera, double alpha) {
+		visible_entities.clear();
+
+		for (std::size_t i{}; i < render_list.size(); ++i) {
+			const Entity entity{ render_list[i] };
+
+			auto& transform{ entity.get_component<TransformComponent>() };
+			auto& sprite{ entity.get_component<SpriteComponent>() };
+
+			if ((make_key(sprite, 0) & ~index_mask) != (render_keys[i] & ~index_mask)) {
+				return false;
+			}
+
+			const glm::dvec2 position{ transform.interpolate(alpha) };
+
+			bool is_outside_camera_view{
+				(position.x + sprite.width * transform.scale.x) < camera->x ||
+				position.x > (camera->x + camera->w) ||
+				(position.y + sprite.height * transform.scale.y) < camera->y ||
+				position.y > (camera->y + camera->h)
 			};
 
-			SDL_RenderCopyEx(
-				renderer,
-				asset_manager.get_texture(sprite.asset_id),
-				&sprite.src_rect,
-				&dest_rect,
-				transform.rotation,
-				nullptr,
-				sprite.flip
-			);
+			if (is_outside_camera_view && !sprite.is_fixed) {
+				continue;
+			}
+
+			visible_entities.push_back(entity);
 		}
+
+		return true;
 	}
 };
 
@@ -4,6 +4,7 @@
 #include "../asset_manager/asset_manager.hpp"
 #include "../ecs/ecs.hpp"
 #include "../components/text_label_component.hpp"
+#include "../renderer/render_snapshot.hpp"
 
 #include <SDL2/SDL.h>
 
@@ -13,49 +14,26 @@ public:
 		require_component<TextLabelComponent>();
 	}
 
-	void update(SDL_Renderer* renderer, AssetManager& asset_manager, SDL_Rect* camera) {
+	void update(AssetManager& asset_manager, RenderSnapshot& snapshot, SDL_Rect* camera) {
 
 		for (const Entity& e : get_entities()) {
 			auto& text_label{ e.get_component<TextLabelComponent>() };
 
-			TTF_Font* font{ asset_manager.get_font(text_label.asset_id) };
-			std::string& text{ text_label.text };
-			SDL_Color color{ text_label.color };
-
-			SDL_Surface* surface{
-				TTF_RenderText_Blended(
-					font,
-					text.c_str(),
-					color
-				)
-			};
-
-			SDL_Texture* texture{
-				SDL_CreateTextureFromSurface(
-					renderer,
-					surface
-				)
-			};
-
-			SDL_FreeSurface(surface);
+			const GlyphAtlas* glyph_atlas{ asset_manager.get_glyph_atlas(text_label.font) };
+			if (glyph_atlas == nullptr) {
+				continue;
+			}
 
 			int camera_x = camera->x * (1 - text_label.is_fixed);
 			int camera_y = camera->y * (1 - text_label.is_fixed);
 
-			int label_width{ 0 };
-			int label_height{ 0 };
-
-			SDL_QueryTexture(texture, nullptr, nullptr, &label_width, &label_height);
-
-			SDL_Rect dest_rect{
-				text_label.position.x - static_cast<int>(camera_x),
-				text_label.position.y - static_cast<int>(camera_y),
-				label_width,
-				label_height
-			};
-
-			SDL_RenderCopy(renderer, texture, nullptr, &dest_rect);
-			SDL_DestroyTexture(texture);
+			glyph_atlas->draw(
+				snapshot,
+				text_label.text,
+				static_cast<float>(text_label.position.x - camera_x),
+				static_cast<float>(text_label.position.y - camera_y),
+				text_label.color
+			);
 		}
 	}
 };
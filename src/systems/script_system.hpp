@@ -2,13 +2,18 @@
 #define SCRIPT_SYSTEM_HPP
 
 #include "../ecs/ecs.hpp"
+#include "../asset_manager/asset_manager.hpp"
+#include "../collision/spatial_query.hpp"
 #include "../components/script_component.hpp"
 #include "../components/transform_component.hpp"
 #include "../components/rigidbody_component.hpp"
 #include "../components/projectile_emitter_component.hpp"
 #include "../components/animation_component.hpp"
+#include "collision_system.hpp"
 
+#include <string>
 #include <tuple>
+#include <vector>
 
 std::tuple<double, double> get_entity_position(Entity entity) {
 	if (entity.has_component<TransformComponent>()) {
@@ -75,23 +80,13 @@ void set_projectile_velocity(Entity entity, double x, double y) {
 	}
 }
 
-void set_animation_frame(Entity entity, int frame) {
-	if (entity.has_component<AnimationComponent>()) {
-		auto& animation{ entity.get_component<AnimationComponent>() };
-		animation.current_frame = frame;
-	}
-	else {
-		Logger::err("Trying to set frame to an entity that does not have a animation component id: " + entity.get_id());
-	}
-}
-
 class ScriptSystem : public System {
 public:
 	ScriptSystem() {
 		require_component<ScriptComponent>();
 	}
 
-	void create_lua_bindings(sol::state& lua) {
+	void create_lua_bindings(sol::state& lua, Registry& registry, CollisionSystem& collision_system, const AssetManager& asset_manager) {
 
 		lua.new_usertype<Entity>(
 			"entity",
@@ -107,7 +102,69 @@ public:
 		lua.set_function("get_velocity", get_entity_velocity);
 		lua.set_function("set_rotation", set_entity_rotation);
 		lua.set_function("set_projectile_velocity", set_projectile_velocity);
-		lua.set_function("set_animation_frame", set_animation_frame);
+
+		// Animation frames live in the shared clip, jumping to one moves the playback to its start
+		lua.set_function(
+			"set_animation_frame",
+			[&asset_manager](Entity entity, int frame) {
+				if (!entity.has_component<AnimationComponent>()) {
+					Logger::err("Trying to set frame to an entity that does not have a animation component id: " + std::to_string(entity.get_id()));
+					return;
+				}
+
+				auto& animation{ entity.get_component<AnimationComponent>() };
+				if (animation.clip.is_valid() && frame >= 0) {
+					animation.time = asset_manager.get_animation_clip(animation.clip).frame_start(static_cast<std::size_t>(frame));
+				}
+			}
+		);
+
+		lua.set_function(
+			"play_animation",
+			[&asset_manager](Entity entity, const std::string& clip_id) {
+				AnimationClipHandle clip{ asset_manager.get_animation_clip_handle(clip_id) };
+
+				if (!entity.has_component<AnimationComponent>() || !clip.is_valid()) {
+					Logger::err("Trying to play animation '" + clip_id + "' on entity id: " + std::to_string(entity.get_id()));
+					return;
+				}
+
+				entity.get_component<AnimationComponent>().play(clip);
+			}
+		);
+
+		// Spatial queries, the optional last arguments restrict the results to a group
+		// and leave out an entity (usually the caller): query_radius(x, y, r, nil, entity)
+		lua.set_function(
+			"query_aabb",
+			[this, &registry, &collision_system](sol::this_state state, double x, double y, double w, double h, sol::optional<std::string> group, sol::optional<Entity> exclude) {
+				query_results.clear();
+				collision_system.query_aabb(x, y, x + w, y + h, make_filter(registry, group, exclude), query_results);
+				return to_table(state, query_results);
+			}
+		);
+
+		lua.set_function(
+			"query_radius",
+			[this, &registry, &collision_system](sol::this_state state, double x, double y, double radius, sol::optional<std::string> group, sol::optional<Entity> exclude) {
+				query_results.clear();
+				collision_system.query_radius(x, y, radius, make_filter(registry, group, exclude), query_results);
+				return to_table(state, query_results);
+			}
+		);
+
+		// Returns the hit entity and its distance, or nil
+		lua.set_function(
+			"raycast",
+			[&registry, &collision_system](double x, double y, double dir_x, double dir_y, double max_distance, sol::optional<std::string> group, sol::optional<Entity> exclude)
+			-> std::tuple<sol::optional<Entity>, sol::optional<double>> {
+				auto hit{ collision_system.raycast(x, y, dir_x, dir_y, max_distance, make_filter(registry, group, exclude)) };
+				if (!hit) {
+					return { sol::nullopt, sol::nullopt };
+				}
+				return { hit->entity, hit->distance };
+			}
+		);
 	}
 
 	void update(double delta_time, Uint32 ellapsed_time) {
@@ -117,6 +174,29 @@ public:
 			script.func(e, delta_time, ellapsed_time);
 		}
 	}
+
+private:
+	std::vector<Entity> query_results{};
+
+	// The group name is interned once per query, candidates then only compare ids
+	static SpatialQueryFilter make_filter(Registry& registry, const sol::optional<std::string>& group, const sol::optional<Entity>& exclude) {
+		SpatialQueryFilter filter{};
+		if (group) {
+			filter.group_id = registry.intern_group(*group);
+		}
+		if (exclude) {
+			filter.exclude_id = exclude->get_id();
+		}
+		return filter;
+	}
+
+	static sol::table to_table(sol::this_state state, const std::vector<Entity>& entities) {
+		sol::table table{ state, sol::create };
+		for (std::size_t i{}; i < entities.size(); ++i) {
+			table[i + 1] = entities[i];
+		}
+		return table;
+	}
 };
 
 #endif //SCRIPT_SYSTEM_HPP
@@ -0,0 +1,95 @@
+#include "thread_pool.hpp"
+
+#include "../logger/logger.hpp"
+
+#include <string>
+
+ThreadPool::ThreadPool(std::size_t worker_count) {
+	if (worker_count == 0) {
+		unsigned hardware_threads{ std::thread::hardware_concurrency() };
+		worker_count = hardware_threads > 1 ? hardware_threads - 1 : 0;
+	}
+
+	workers.reserve(worker_count);
+	for (std::size_t i{}; i < worker_count; ++i) {
+		workers.emplace_back(&ThreadPool::worker_loop, this);
+	}
+
+	Logger::log("Thread pool created with " + std::to_string(worker_count) + " workers!");
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard lock{ mutex };
+		is_stopping = true;
+	}
+	work_ready.notify_all();
+
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+
+	Logger::log("Thread pool destroyed!");
+}
+
+void ThreadPool::run(std::size_t count, const std::function<void(std::size_t)>& task) {
+	if (count == 0) {
+		return;
+	}
+
+	if (count == 1 || workers.empty()) {
+		for (std::size_t i{}; i < count; ++i) {
+			task(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard lock{ mutex };
+		current_task = &task;
+		task_count = count;
+		next_index.store(0, std::memory_order_relaxed);
+		busy_workers = workers.size();
+		++generation;
+	}
+	work_ready.notify_all();
+
+	execute();
+
+	std::unique_lock lock{ mutex };
+	work_done.wait(lock, [this] { return busy_workers == 0; });
+	current_task = nullptr;
+}
+
+void ThreadPool::worker_loop() {
+	std::uint64_t seen_generation{};
+
+	while (true) {
+		{
+			std::unique_lock lock{ mutex };
+			work_ready.wait(lock, [this, seen_generation] {
+				return is_stopping || generation != seen_generation;
+			});
+
+			if (is_stopping) {
+				return;
+			}
+
+			seen_generation = generation;
+		}
+
+		execute();
+
+		{
+			std::lock_guard lock{ mutex };
+			--busy_workers;
+		}
+		work_done.notify_one();
+	}
+}
+
+void ThreadPool::execute() {
+	for (std::size_t i{ next_index.fetch_add(1) }; i < task_count; i = next_index.fetch_add(1)) {
+		(*current_task)(i);
+	}
+}
@@ -0,0 +1,51 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+* Fixed set of worker threads that stay alive for the whole game,
+* so systems can split per-frame work without spawning threads.
+*/
+class ThreadPool {
+public:
+	// 0 workers = hardware threads - 1, the calling thread always takes part in run().
+	explicit ThreadPool(std::size_t worker_count = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Number of threads that execute tasks in run(), including the caller.
+	std::size_t size() const { return workers.size() + 1; }
+
+	// Calls task(index) for every index in [0, count) across the pool and
+	// returns once all of them are done. Not reentrant.
+	void run(std::size_t count, const std::function<void(std::size_t)>& task);
+
+private:
+	std::vector<std::thread> workers{};
+
+	std::mutex mutex{};
+	std::condition_variable work_ready{};
+	std::condition_variable work_done{};
+
+	const std::function<void(std::size_t)>* current_task{ nullptr };
+	std::size_t task_count{};
+	std::atomic<std::size_t> next_index{};
+	std::size_t busy_workers{};
+	std::uint64_t generation{};
+	bool is_stopping{ false };
+
+	void worker_loop();
+	void execute();
+};
+
+#endif //THREAD_POOL_HPP
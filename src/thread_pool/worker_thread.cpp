@@ -0,0 +1,62 @@
+#include "worker_thread.hpp"
+
+#include <utility>
+
+WorkerThread::WorkerThread() {
+	thread = std::thread{ &WorkerThread::loop, this };
+}
+
+WorkerThread::~WorkerThread() {
+	{
+		std::lock_guard lock{ mutex };
+		is_stopping = true;
+	}
+	job_ready.notify_one();
+
+	thread.join();
+}
+
+void WorkerThread::start(std::function<void()> job) {
+	{
+		std::lock_guard lock{ mutex };
+		this->job = std::move(job);
+		has_job = true;
+	}
+	job_ready.notify_one();
+}
+
+void WorkerThread::wait() {
+	std::unique_lock lock{ mutex };
+	job_done.wait(lock, [this] { return !has_job; });
+
+	if (error) {
+		std::rethrow_exception(std::exchange(error, nullptr));
+	}
+}
+
+void WorkerThread::loop() {
+	std::unique_lock lock{ mutex };
+
+	while (true) {
+		job_ready.wait(lock, [this] { return has_job || is_stopping; });
+
+		if (!has_job) {
+			return;
+		}
+
+		lock.unlock();
+		try {
+			job();
+		}
+		catch (...) {
+			lock.lock();
+			error = std::current_exception();
+			lock.unlock();
+		}
+		lock.lock();
+
+		job = nullptr;
+		has_job = false;
+		job_done.notify_all();
+	}
+}
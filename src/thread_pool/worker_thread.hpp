@@ -0,0 +1,43 @@
+#ifndef WORKER_THREAD_HPP
+#define WORKER_THREAD_HPP
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/*
+* A single thread kept alive for the whole game that runs one job at a time,
+* so a long step (the simulation of the next frame) can overlap work on the calling thread.
+*/
+class WorkerThread {
+public:
+	WorkerThread();
+	~WorkerThread();
+
+	WorkerThread(const WorkerThread&) = delete;
+	WorkerThread& operator=(const WorkerThread&) = delete;
+
+	// Only one job at a time: wait() must return before the next start().
+	void start(std::function<void()> job);
+
+	// Blocks until the job is done, rethrows what it threw.
+	void wait();
+
+private:
+	std::mutex mutex{};
+	std::condition_variable job_ready{};
+	std::condition_variable job_done{};
+
+	std::function<void()> job{};
+	std::exception_ptr error{};
+	bool has_job{ false };
+	bool is_stopping{ false };
+
+	std::thread thread{};
+
+	void loop();
+};
+
+#endif //WORKER_THREAD_HPP
@@ -0,0 +1,123 @@
+#include "tilemap.hpp"
+
+#include "../logger/logger.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+void Tilemap::reset(int rows, int cols, int tile_size, double scale) {
+	this->rows = rows;
+	this->cols = cols;
+	this->tile_size = tile_size;
+	this->scale = scale;
+	solid.clear();
+	tiles.assign(static_cast<std::size_t>(rows) * static_cast<std::size_t>(cols), {});
+	texture = {};
+	++version;
+}
+
+void Tilemap::set_texture(TextureHandle texture) {
+	this->texture = texture;
+	++version;
+}
+
+void Tilemap::set_tile(int col, int row, Tile tile) {
+	if (col < 0 || row < 0 || col >= cols || row >= rows) {
+		return;
+	}
+
+	tiles[static_cast<std::size_t>(row) * static_cast<std::size_t>(cols) + static_cast<std::size_t>(col)] = tile;
+	++version;
+}
+
+bool Tilemap::load_solidity(const std::string& path) {
+	std::ifstream file{ path };
+
+	if (!file) {
+		Logger::err("Failed to open tilemap solidity at path: " + path);
+		return false;
+	}
+
+	std::size_t cell_count{ static_cast<std::size_t>(rows) * static_cast<std::size_t>(cols) };
+	solid.assign((cell_count + 63) / 64, 0);
+
+	std::string line{};
+	std::string token{};
+
+	for (int row{}; row < rows && std::getline(file, line); ++row) {
+		std::istringstream stream{ line };
+
+		for (int col{}; col < cols && std::getline(stream, token, ','); ++col) {
+			// Surrounding blanks (and the '\r' of CRLF files) are ignored
+			const std::size_t first{ token.find_first_not_of(" \t\r") };
+			const std::size_t last{ token.find_last_not_of(" \t\r") };
+
+			int value{};
+			std::from_chars_result result{};
+
+			if (first != std::string::npos) {
+				result = std::from_chars(token.data() + first, token.data() + last + 1, value);
+			}
+
+			if (first == std::string::npos || result.ec != std::errc{} || result.ptr != token.data() + last + 1) {
+				Logger::err(
+					"Invalid value '" + token + "' in tilemap solidity at row " + std::to_string(row) +
+					", column " + std::to_string(col) + ", loading the level without solidity: " + path
+				);
+				solid.clear();
+				return false;
+			}
+
+			if (value != 0) {
+				set_solid(col, row);
+			}
+		}
+	}
+
+	Logger::log("Tilemap solidity loaded from: " + path);
+	return true;
+}
+
+bool Tilemap::is_solid(int col, int row) const {
+	if (solid.empty() || col < 0 || row < 0 || col >= cols || row >= rows) {
+		return false;
+	}
+
+	std::size_t cell{ static_cast<std::size_t>(row) * static_cast<std::size_t>(cols) + static_cast<std::size_t>(col) };
+	return (solid[cell / 64] >> (cell % 64)) & 1;
+}
+
+bool Tilemap::overlaps_solid(double x1, double y1, double x2, double y2, int& col, int& row) const {
+	if (solid.empty()) {
+		return false;
+	}
+
+	const double size{ get_tile_world_size() };
+
+	// Cells touched by the box, the max edge is exclusive like the collider overlap test
+	int first_col{ std::max(static_cast<int>(std::floor(x1 / size)), 0) };
+	int first_row{ std::max(static_cast<int>(std::floor(y1 / size)), 0) };
+	int last_col{ std::min(static_cast<int>(std::ceil(x2 / size)) - 1, cols - 1) };
+	int last_row{ std::min(static_cast<int>(std::ceil(y2 / size)) - 1, rows - 1) };
+
+	for (int r{ first_row }; r <= last_row; ++r) {
+		for (int c{ first_col }; c <= last_col; ++c) {
+			if (is_solid(c, r)) {
+				col = c;
+				row = r;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void Tilemap::set_solid(int col, int row) {
+	std::size_t cell{ static_cast<std::size_t>(row) * static_cast<std::size_t>(cols) + static_cast<std::size_t>(col) };
+	solid[cell / 64] |= std::uint64_t{ 1 } << (cell % 64);
+}
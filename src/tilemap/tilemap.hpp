@@ -0,0 +1,68 @@
+#ifndef TILEMAP_HPP
+#define TILEMAP_HPP
+
+#include "../asset_manager/asset_handle.hpp"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/*
+* Grid description of the level map: which cell of the tile sheet every tile shows,
+* rendered in chunks by the TilemapRenderer, tiles never become entities.
+* An optional solidity bitmap lets colliders be tested against the tiles by direct cell lookup.
+*/
+class Tilemap {
+public:
+	Tilemap() = default;
+
+	void reset(int rows, int cols, int tile_size, double scale);
+
+	// Reads a file laid out like the .map file, one comma separated value per tile,
+	// where any value other than 0 marks the tile as solid.
+	bool load_solidity(const std::string& path);
+
+	int get_rows() const { return rows; }
+	int get_cols() const { return cols; }
+	int get_tile_size() const { return tile_size; }
+	double get_scale() const { return scale; }
+	double get_tile_world_size() const { return tile_size * scale; }
+
+	// Tile sheet cell (column, row) shown by each tile
+	struct Tile {
+		std::int16_t src_col{};
+		std::int16_t src_row{};
+	};
+
+	void set_texture(TextureHandle texture);
+	TextureHandle get_texture() const { return texture; }
+
+	void set_tile(int col, int row, Tile tile);
+	const Tile& get_tile(int col, int row) const {
+		return tiles[static_cast<std::size_t>(row) * static_cast<std::size_t>(cols) + static_cast<std::size_t>(col)];
+	}
+
+	// Bumped whenever the tiles change, so renderers know when to rebuild.
+	std::uint32_t get_version() const { return version; }
+
+	bool has_solidity() const { return !solid.empty(); }
+	bool is_solid(int col, int row) const;
+
+	// Returns true if any solid tile overlaps the world space box,
+	// 'col'/'row' receive the first solid cell found.
+	bool overlaps_solid(double x1, double y1, double x2, double y2, int& col, int& row) const;
+
+private:
+	int rows{};
+	int cols{};
+	int tile_size{};
+	double scale{ 1.0 };
+	std::vector<std::uint64_t> solid{};
+	std::vector<Tile> tiles{};
+	TextureHandle texture{};
+	std::uint32_t version{};
+
+	void set_solid(int col, int row);
+};
+
+#endif //TILEMAP_HPP
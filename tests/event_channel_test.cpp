@@ -0,0 +1,84 @@
+#include "../src/event_manager/event_manager.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/*
+* Stress test of EventChannel: 8 producer threads push through small rings while the
+* main thread consumes concurrently. Every event must arrive exactly once, and the
+* events of a producer in the order it pushed them.
+*/
+namespace {
+
+	constexpr std::size_t producers{ 8 };
+	constexpr std::size_t capacity{ 256 };
+	constexpr std::uint32_t events_per_producer{ 50000 };
+
+	class SequenceEvent : public Event {
+	public:
+		std::uint32_t producer{};
+		std::uint32_t sequence{};
+
+		SequenceEvent(std::uint32_t producer, std::uint32_t sequence) : producer{ producer }, sequence{ sequence } {}
+	};
+
+	bool run() {
+		EventChannel<SequenceEvent> channel{ producers, capacity };
+
+		std::vector<std::thread> threads{};
+		for (std::size_t p{}; p < producers; ++p) {
+			threads.emplace_back([&channel, p] {
+				for (std::uint32_t i{}; i < events_per_producer; ++i) {
+					// A full ring is expected with such a small capacity, retry until the consumer catches up
+					while (!channel.try_push(p, static_cast<std::uint32_t>(p), i)) {
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+
+		std::vector<std::uint32_t> next(producers, 0);
+		std::size_t received{};
+		bool passed{ true };
+
+		while (received < producers * events_per_producer && passed) {
+			channel.consume([&](SequenceEvent&& event) {
+				if (event.producer >= producers || event.sequence != next[event.producer]) {
+					std::cerr << "Unexpected event " << event.sequence << " from producer " << event.producer << "\n";
+					passed = false;
+					return;
+				}
+
+				++next[event.producer];
+				++received;
+			});
+		}
+
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+
+		// Nothing may be left or published twice once all the producers are done
+		channel.consume([&](SequenceEvent&&) { passed = false; });
+
+		for (std::size_t p{}; p < producers; ++p) {
+			if (next[p] != events_per_producer) {
+				std::cerr << "Producer " << p << ": " << next[p] << " events received out of " << events_per_producer << "\n";
+				passed = false;
+			}
+		}
+
+		return passed;
+	}
+}
+
+int main() {
+	bool passed{ run() };
+
+	std::cout << "event_channel_test: " << (passed ? "passed" : "FAILED") << "\n";
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}